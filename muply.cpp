@@ -1,5 +1,23 @@
 #include "muply.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MUPLY_SSE2
+#include <emmintrin.h>
+#endif
+
 PlyEncoding str2PlyEncoding(const char* str) {
 	if (!strcmp(str, "ascii")) {
 		return PlyEncoding::ASCII;
@@ -32,6 +50,9 @@ PlyType str2PlyType(const char* str) {
 	if (!strcmp(str, "ushort") || !strcmp(str, "uint16")) {
 		return PlyType::UINT16;
 	}
+	if (!strcmp(str, "uint") || !strcmp(str, "uint32")) {
+		return PlyType::UINT32;
+	}
 	if (!strcmp(str, "ulong") || !strcmp(str, "uint64")) {
 		return PlyType::UINT64;
 	}
@@ -90,127 +111,402 @@ void byteSwap64(void* ptr, const size_t elementCount) {
 	}
 }
 
+static size_t readStdio(void* handle, void* buffer, size_t size) {
+	return fread(buffer, 1, size, (FILE*)handle);
+}
+
+static bool seekStdio(void* handle, long offset) {
+	return !fseek((FILE*)handle, offset, SEEK_SET);
+}
+
+static void closeStdio(void* handle) {
+	fclose((FILE*)handle);
+}
+
+static size_t readFd(void* handle, void* buffer, size_t size) {
+#ifdef _WIN32
+	const int result = _read((int)(intptr_t)handle, buffer, (unsigned int)size);
+#else
+	const ssize_t result = read((int)(intptr_t)handle, buffer, size);
+#endif
+	return (result > 0) ? (size_t)result : 0;
+}
+
+static bool seekFd(void* handle, long offset) {
+#ifdef _WIN32
+	return _lseek((int)(intptr_t)handle, offset, SEEK_SET) == offset;
+#else
+	return lseek((int)(intptr_t)handle, (off_t)offset, SEEK_SET) == (off_t)offset;
+#endif
+}
+
+uint16_t byteSwapValue16(const uint16_t val) {
+	return (uint16_t)((val >> 8) | (val << 8));
+}
+
+uint32_t byteSwapValue32(const uint32_t val) {
+	return ((val >> 24) & 0x000000FFu) | ((val >> 8) & 0x0000FF00u) |
+		((val << 8) & 0x00FF0000u) | ((val << 24) & 0xFF000000u);
+}
+
+uint64_t byteSwapValue64(const uint64_t val) {
+	return ((uint64_t)byteSwapValue32((uint32_t)val) << 32) | byteSwapValue32((uint32_t)(val >> 32));
+}
+
+bool requiresByteSwap(const PlyFile* file) {
+	if (file->encoding == PlyEncoding::BINARY_LITTLE_ENDIAN) {
+		return !isLittleEndian();
+	}
+	if (file->encoding == PlyEncoding::BINARY_BIG_ENDIAN) {
+		return isLittleEndian();
+	}
+	return false;
+}
+
+#ifndef _WIN32
+static size_t readAtFd(void* handle, void* buffer, size_t size, long offset) {
+	// pread may return partial reads
+	size_t total = 0;
+	ssize_t result;
+	while (total < size) {
+		result = pread((int)(intptr_t)handle, (char*)buffer + total, size - total, (off_t)(offset + total));
+		if (result <= 0) {
+			break;
+		}
+		total += (size_t)result;
+	}
+	return total;
+}
+
+static size_t readAtStdio(void* handle, void* buffer, size_t size, long offset) {
+	return readAtFd((void*)(intptr_t)fileno((FILE*)handle), buffer, size, offset);
+}
+#endif
+
+/*
+* Cursor of a source view reading through the positioned reads of a shared source.
+*/
+struct PlySourceView {
+	// shared source
+	const PlySource* base = NULL;
+	// current position
+	long offset = 0;
+};
+
+static size_t readView(void* handle, void* buffer, size_t size) {
+	PlySourceView* view = (PlySourceView*)handle;
+	const size_t count = view->base->readAt(view->base->handle, buffer, size, view->offset);
+	view->offset += (long)count;
+	return count;
+}
+
+static bool seekView(void* handle, long offset) {
+	((PlySourceView*)handle)->offset = offset;
+	return true;
+}
+
+static size_t readAtView(void* handle, void* buffer, size_t size, long offset) {
+	const PlySourceView* view = (const PlySourceView*)handle;
+	return view->base->readAt(view->base->handle, buffer, size, offset);
+}
+
+static void closeView(void* handle) {
+	free(handle);
+}
+
 PlyFile openPly(const char* path) {
+	PlySource source;
+	// check file existence
+	if (!openFileSource(path, &source)) {
+		return PlyFile();
+	}
+	return openPlySource(source);
+}
+
+bool openFileSource(const char* path, PlySource* source) {
+	FILE* file = fopen(path, "rb");
+	if (!file) {
+		return false;
+	}
+	*source = PlySource();
+	source->handle = file;
+	source->read = readStdio;
+	source->seek = seekStdio;
+	source->close = closeStdio;
+#ifndef _WIN32
+	source->readAt = readAtStdio;
+#endif
+	return true;
+}
+
+PlyFile openPlyBuffer(const void* buffer, const size_t size) {
+	// in-memory sources read directly from the given buffer
+	PlySource source;
+	source.buffer = (char*)buffer;
+	source.bufferSize = size;
+	source.bufferFill = size;
+	return openPlySource(source);
+}
+
+PlyFile openPlyFd(const int fd) {
+	PlySource source;
+	source.handle = (void*)(intptr_t)fd;
+	source.read = readFd;
+	// pipes and sockets do not support seeking
+#ifdef _WIN32
+	if (_lseek(fd, 0, SEEK_CUR) >= 0) {
+#else
+	if (lseek(fd, 0, SEEK_CUR) >= 0) {
+#endif
+		source.seek = seekFd;
+#ifndef _WIN32
+		source.readAt = readAtFd;
+#endif
+	}
+	return openPlySource(source);
+}
+
+PlyFile openPlyStream(FILE* stream) {
+	PlySource source;
+	source.handle = stream;
+	source.read = readStdio;
+	return openPlySource(source);
+}
+
+PlyFile openPlySource(PlySource source) {
+	PlyFile pfile = openPlyHeader(source);
+	// forward-only sources are inspected while reading
+	if (pfile.elementCount && sourceSeekable(&pfile.source)) {
+		inspectData(&pfile);
+	}
+	return pfile;
+}
+
+PlyFile openPlyHeader(PlySource source) {
+	PlyFile pfile;
+	pfile.source = source;
+	initSource(&pfile.source);
+	// read and parse header section
+	size_t headerSize;
+	char* header = readHeader(&pfile.source, &headerSize);
+	if (!header || !parseHeader(&pfile, header, headerSize)) {
+		free(header);
+		closePly(&pfile);
+		return pfile;
+	}
+	free(header);
+	return pfile;
+}
+
+PlyFile probePly(const char* path) {
 	PlyFile pfile;
-	pfile.file = fopen(path, "rb");
+	FILE* file = fopen(path, "rb");
 	// check file existence
-	if (!pfile.file) {
+	if (!file) {
 		return pfile;
 	}
-	// allocate buffer for reading
+	// read header bytes only through a small unbuffered source and release file immediately
+	setvbuf(file, NULL, _IONBF, 0);
+	PlySource source;
+	source.handle = file;
+	source.read = readStdio;
+	source.close = closeStdio;
+	source.bufferSize = MUPLY_PROBE_BUFFER_SIZE;
+	source.buffer = (char*)malloc(source.bufferSize);
+	source.ownsBuffer = true;
+	initSource(&source);
+	size_t headerSize;
+	char* header = readHeader(&source, &headerSize);
+	closeSource(&source);
+	if (header) {
+		parseHeader(&pfile, header, headerSize);
+		free(header);
+	}
+	return pfile;
+}
+
+PlyFile probePlyBuffer(const void* buffer, const size_t size) {
+	PlyFile pfile;
+	parseHeader(&pfile, (const char*)buffer, size);
+	return pfile;
+}
+
+char* readHeader(PlySource* source, size_t* size) {
+	char line[MUPLY_BUFFER_SIZE];
+	size_t capacity = 4 * MUPLY_BUFFER_SIZE;
+	size_t length = 0;
+	size_t lineLength;
+	char* header = (char*)malloc(capacity);
+	*size = 0;
+	// collect lines until end of header
+	while (sourceGets(source, line, MUPLY_BUFFER_SIZE)) {
+		lineLength = strlen(line);
+		if (length + lineLength > capacity) {
+			capacity *= 2;
+			header = (char*)realloc(header, capacity);
+		}
+		memcpy(header + length, line, lineLength);
+		length += lineLength;
+		if (!strncmp(line, "end_header", 10)) {
+			*size = length;
+			return header;
+		}
+	}
+	// incomplete header
+	free(header);
+	return NULL;
+}
+
+const char* nextHeaderLine(const char* pos, const char* end, char* line) {
+	size_t length = 0;
+	while (pos < end && *pos != '\n') {
+		if (length < MUPLY_BUFFER_SIZE - 1) {
+			line[length++] = *pos;
+		}
+		++pos;
+	}
+	line[length] = '\0';
+	// skip line break
+	return (pos < end) ? pos + 1 : pos;
+}
+
+bool parseHeader(PlyFile* file, const char* header, const size_t size) {
 	char* token;
-	char buffer[MUPLY_BUFFER_SIZE];
+	char line[MUPLY_BUFFER_SIZE];
+	const char* end = header + size;
+	const char* pos = nextHeaderLine(header, end, line);
 	// check file validity
-	fgets(buffer, MUPLY_BUFFER_SIZE, pfile.file);
-	if (strcmp(buffer, "ply\n")) {
-		fclose(pfile.file);
-		pfile.file = NULL;
-		return pfile;
+	token = strtok(line, MUPLY_TOKEN_SEP);
+	if (!token || strcmp(token, "ply")) {
+		return false;
 	}
-	// get format and encoding, count elements, allocate element memory
-	pfile.elementCount = 0;
-	while (!feof(pfile.file)) {
-		fgets(buffer, MUPLY_BUFFER_SIZE, pfile.file);
-		token = strtok(buffer, MUPLY_TOKEN_SEP);
+	const char* bodyStart = pos;
+	// get format and encoding, count elements, find end of header
+	bool complete = false;
+	int elementCount = 0;
+	while (pos < end) {
+		pos = nextHeaderLine(pos, end, line);
+		token = strtok(line, MUPLY_TOKEN_SEP);
+		if (!token) {
+			continue;
+		}
 		if (!strcmp(token, "format")) {
 			// get format
 			token = strtok(NULL, MUPLY_TOKEN_SEP);
-			pfile.encoding = str2PlyEncoding(token);
+			file->encoding = token ? str2PlyEncoding(token) : PlyEncoding::UNKNOWN;
 			continue;
 		}
 		if (!strcmp(token, "element")) {
 			// count number of elements
-			pfile.elementCount += 1;
+			elementCount += 1;
 			continue;
 		}
 		if (!strcmp(token, "end_header")) {
+			complete = true;
 			break;
 		}
 	}
-	pfile.elements = (PlyElement*)malloc(pfile.elementCount * sizeof(PlyElement));
-	// count per-element properties and allocate property memory
+	if (!complete) {
+		file->encoding = PlyEncoding::UNKNOWN;
+		return false;
+	}
+	const char* bodyEnd = pos;
+	file->dataStart = (long)(bodyEnd - header);
+	file->elementCount = elementCount;
+	file->elements = (PlyElement*)malloc(elementCount * sizeof(PlyElement));
+	// count per-element properties, get names and item counts
 	PlyElement elem;
 	int elementIdx = -1;
-	pfile.dataStart = ftell(pfile.file);
-	fseek(pfile.file, 0, SEEK_SET);
-	while (!feof(pfile.file)) {
-		fgets(buffer, MUPLY_BUFFER_SIZE, pfile.file);
-		token = strtok(buffer, MUPLY_TOKEN_SEP);
+	pos = bodyStart;
+	while (pos < bodyEnd) {
+		pos = nextHeaderLine(pos, bodyEnd, line);
+		token = strtok(line, MUPLY_TOKEN_SEP);
+		if (!token) {
+			continue;
+		}
 		if (!strcmp(token, "element")) {
 			// initialize element
 			if (elementIdx >= 0) {
-				elem.properties = (PlyProperty*)malloc(elem.propertyCount * sizeof(PlyProperty));
-				pfile.elements[elementIdx] = elem;
+				file->elements[elementIdx] = elem;
 			}
 			++elementIdx;
-			elem.propertyCount = 0;
+			elem = PlyElement();
 			// get element name
 			token = strtok(NULL, MUPLY_TOKEN_SEP);
+			token = token ? token : (char*)"";
 			elem.nameLength = strlen(token);
 			elem.name = (char*)malloc(elem.nameLength + 1);
 			strcpy(elem.name, token);
 			// get number elements
 			token = strtok(NULL, MUPLY_TOKEN_SEP);
-			elem.itemCount = atoi(token);
+			elem.itemCount = token ? (size_t)strtoull(token, NULL, 10) : 0;
+			elem.fileItemCount = elem.itemCount;
 			continue;
 		}
-		if (!strcmp(token, "property")) {
+		if (!strcmp(token, "property") && elementIdx >= 0) {
 			// count element properties
 			elem.propertyCount += 1;
 			continue;
 		}
-		if (!strcmp(token, "end_header")) {
-			break;
-		}
 	}
-	pfile.elements[elementIdx] = elem;
+	if (elementIdx >= 0) {
+		file->elements[elementIdx] = elem;
+	}
 	// populate per-element properties
 	elementIdx = -1;
 	size_t propertyIdx = 0;
-	fseek(pfile.file, 0, SEEK_SET);
-	while (!feof(pfile.file)) {
-		fgets(buffer, MUPLY_BUFFER_SIZE, pfile.file);
-		token = strtok(buffer, MUPLY_TOKEN_SEP);
+	pos = bodyStart;
+	while (pos < bodyEnd) {
+		pos = nextHeaderLine(pos, bodyEnd, line);
+		token = strtok(line, MUPLY_TOKEN_SEP);
+		if (!token) {
+			continue;
+		}
 		if (!strcmp(token, "element")) {
 			// switch to next element and initialize properties
 			if (elementIdx >= 0) {
-				pfile.elements[elementIdx] = elem;
+				file->elements[elementIdx] = elem;
 			}
 			++elementIdx;
 			propertyIdx = 0;
-			elem = pfile.elements[elementIdx];
+			elem = file->elements[elementIdx];
 			elem.properties = (PlyProperty*)malloc(elem.propertyCount * sizeof(PlyProperty));
 			continue;
 		}
-		if (!strcmp(token, "property")) {
+		if (!strcmp(token, "property") && elementIdx >= 0) {
 			// get property
 			PlyProperty prop;
 			token = strtok(NULL, MUPLY_TOKEN_SEP);
-			if (!strcmp(token, "list")) {				
+			if (token && !strcmp(token, "list")) {
 				// set as list if necessary
 				token = strtok(NULL, MUPLY_TOKEN_SEP);
-				prop.listType = str2PlyType(token);
+				prop.listType = token ? str2PlyType(token) : PlyType::UNKOWN;
 				token = strtok(NULL, MUPLY_TOKEN_SEP);
 			}
 			else {
 				prop.listType = PlyType::NONE;
 			}
 			// get property type
-			prop.type = str2PlyType(token);
+			prop.type = token ? str2PlyType(token) : PlyType::UNKOWN;
 			token = strtok(NULL, MUPLY_TOKEN_SEP);
+			token = token ? token : (char*)"";
 			prop.nameLength = strlen(token);
 			prop.name = (char*)malloc(prop.nameLength + 1);
-			strcpy(prop.name, token);			
+			strcpy(prop.name, token);
+			// sizes of non-list properties are known from header
+			if (prop.listType == PlyType::NONE) {
+				prop.propertySize = (long)(elem.itemCount * PlyTypeSizes[prop.type]);
+			}
 			elem.properties[propertyIdx++] = prop;
 			continue;
 		}
-		if (!strcmp(token, "end_header")) {
-			break;
-		}
 	}
-	pfile.elements[elementIdx] = elem;
-	inspectData(&pfile);
-	return pfile;
+	if (elementIdx >= 0) {
+		file->elements[elementIdx] = elem;
+		// first element block starts right after header
+		file->elements[0].dataStart = file->dataStart;
+	}
+	return true;
 }
 
 void inspectData(PlyFile* file) {
@@ -224,151 +520,183 @@ void inspectData(PlyFile* file) {
 }
 
 void inspectDataAscii(PlyFile* file) {
-	// skip to global data start
-	fseek(file->file, file->dataStart, SEEK_SET);
-	// buffer setup
-	char buffer[MUPLY_BUFFER_SIZE];
-	// setup
-	size_t itemSize;
-	long dataStart = file->dataStart;
-	bool fixedLength;
-	// get block size of each element
-	int64_t listElements = 0;
-	char* token;
-	PlyElement elem;
+	// inspect elements in file order
 	const size_t eCount = file->elementCount;
-	PlyProperty prop;
-	PlyProperty* props;
-	size_t pCount, iCount;
 	for (size_t e = 0; e < eCount; ++e) {
-		// property setup
-		fixedLength = true;
-		elem = file->elements[e];
-		elem.dataStart = dataStart;
-		props = elem.properties;
-		pCount = elem.propertyCount;
-		iCount = elem.itemCount;
-		// check for variable length properties
-		for (size_t p = 0; p < pCount; ++p) {
-			fixedLength &= (props[p].listType == PlyType::NONE);
+		if (!inspectElementAscii(file, e)) {
+			break;
 		}
-		// inspect fixed-size property blocks
-		if (fixedLength) {
-			// set sizes of each property block
-			for (size_t p = 0; p < pCount; ++p) {
-				prop = props[p];
-				props[p].propertySize = (long)(elem.itemCount * PlyTypeSizes[prop.type]);
-			}
-			// skip through block of elements
-			for (size_t i = 0; i < elem.itemCount; ++i) {
-				fgets(buffer, MUPLY_BUFFER_SIZE, file->file);
-			}
+	}
+}
+
+void inspectDataBinary(PlyFile* file) {
+	// inspect elements in file order
+	const size_t eCount = file->elementCount;
+	for (size_t e = 0; e < eCount; ++e) {
+		if (!inspectElementBinary(file, e)) {
+			break;
 		}
-		else {
-			// forward skips of varying length in case of non-fixed length
-			for (size_t i = 0; i < iCount; ++i) {
-				fgets(buffer, MUPLY_BUFFER_SIZE, file->file);
-				token = strtok(buffer, MUPLY_TOKEN_SEP);
+	}
+}
+
+bool inspectElement(PlyFile* file, const size_t elemIdx) {
+	// forward to suitable inspection function
+	if (file->encoding == PlyEncoding::ASCII) {
+		return inspectElementAscii(file, elemIdx);
+	}
+	return inspectElementBinary(file, elemIdx);
+}
+
+bool inspectElementAscii(PlyFile* file, const size_t elemIdx) {
+	// property setup
+	PlyElement elem = file->elements[elemIdx];
+	PlyProperty* props = elem.properties;
+	const size_t pCount = elem.propertyCount;
+	PlySource* source = &file->source;
+	// skip to element data start
+	if (!sourceSeek(source, elem.dataStart)) {
+		return false;
+	}
+	// setup
+	size_t itemSize;
+	bool fixedLength = true;
+	int64_t listElements = 0;
+	char token[MUPLY_TOKEN_SIZE];
+	PlyProperty prop;
+	// check for variable length properties
+	for (size_t p = 0; p < pCount; ++p) {
+		fixedLength &= (props[p].listType == PlyType::NONE);
+	}
+	// set or reset sizes of each property block
+	for (size_t p = 0; p < pCount; ++p) {
+		props[p].propertySize = fixedLength ? (long)(elem.fileItemCount * PlyTypeSizes[props[p].type]) : 0;
+	}
+	// scan staged chunks of complete lines
+	size_t remaining = elem.fileItemCount;
+	size_t chunkSize = MUPLY_CHUNK_SIZE;
+	size_t lines, used, skipped;
+	const char *pos, *end, *tokenEnd;
+	while (remaining && (lines = stageLines(source, remaining, &chunkSize, &used))) {
+		// fixed-size items only need their line breaks counted
+		if (!fixedLength) {
+			pos = source->buffer + source->bufferPos;
+			end = pos + used;
+			for (size_t l = 0; l < lines; ++l) {
 				for (size_t p = 0; p < pCount; ++p) {
-					prop = elem.properties[p];
+					pos = skipSpaces(pos, end);
+					tokenEnd = skipToken(pos, end);
+					if (pos == tokenEnd) {
+						break;
+					}
+					prop = props[p];
 					itemSize = PlyTypeSizes[prop.type];
 					// treat list case
 					if (prop.listType != PlyType::NONE) {
-						listElements = (int64_t)atol(token);
+						listElements = (int64_t)atol(copyToken(pos, tokenEnd, token));
 						prop.propertySize += (long)(listElements * itemSize);
 						// skip list entries
-						for (int s = 0; s < listElements; ++s) {
-							strtok(NULL, MUPLY_TOKEN_SEP);
+						for (int64_t s = 0; s < listElements; ++s) {
+							tokenEnd = skipToken(skipSpaces(tokenEnd, end), end);
 						}
 					}
 					else {
 						prop.propertySize += (long)itemSize;
 					}
-					// get next property element
-					token = strtok(NULL, MUPLY_TOKEN_SEP);
+					pos = tokenEnd;
 					props[p] = prop;
 				}
+				// skip remainder of line
+				skipped = 1;
+				pos = findLines(pos, end - pos, &skipped);
 			}
 		}
-		dataStart = ftell(file->file);
-		file->elements[e] = elem;
+		source->bufferPos += used;
+		remaining -= lines;
 	}
+	// start of next element is known now
+	if (elemIdx + 1 < (size_t)file->elementCount) {
+		file->elements[elemIdx + 1].dataStart = sourceTell(source);
+	}
+	return true;
 }
 
-void inspectDataBinary(PlyFile* file) {
-	// skip to global data start
-	fseek(file->file, file->dataStart, SEEK_SET);
+bool inspectElementBinary(PlyFile* file, const size_t elemIdx) {
+	// property setup
+	PlyElement elem = file->elements[elemIdx];
+	PlyProperty* props = elem.properties;
+	const size_t pCount = elem.propertyCount;
+	const size_t iCount = elem.fileItemCount;
+	// skip to element data start
+	if (!sourceSeek(&file->source, elem.dataStart)) {
+		return false;
+	}
 	// setup
 	size_t listTypeSize, blockSize, itemSize;
-	long dataStart = file->dataStart;
-	bool fixedLength;
-	// get block size of each element
+	bool fixedLength = true;
+	const bool swap = requiresByteSwap(file);
+	char listBuffer[sizeof(int64_t)];
 	int64_t listElements = 0;
-	PlyElement elem;
-	const size_t eCount = file->elementCount;
 	PlyProperty prop;
-	PlyProperty* props;
-	size_t pCount, iCount;
-	for (size_t e = 0; e < eCount; ++e) {
-		// property setup
-		fixedLength = true;
-		elem = file->elements[e];
-		elem.dataStart = dataStart;
-		props = elem.properties;
-		pCount = elem.propertyCount;
-		iCount = elem.itemCount;
-		// check for variable length properties
+	// check for variable length properties
+	for (size_t p = 0; p < pCount; ++p) {
+		prop = props[p];
+		if (prop.listType != PlyType::NONE) {
+			fixedLength = false;
+		}
+	}
+	// estimate property blocks
+	if (fixedLength) {
+		// calculate fixed-size block dimensions
+		blockSize = 0;
 		for (size_t p = 0; p < pCount; ++p) {
-			prop = elem.properties[p];
-			if (prop.listType != PlyType::NONE) {
-				fixedLength = false;
-			}
+			prop = props[p];
+			prop.propertySize = (long)(iCount * PlyTypeSizes[prop.type]);
+			blockSize += prop.propertySize;
+			props[p] = prop;
 		}
-		// estimate property blocks
-		if (fixedLength) {
-			// calculate fixed-size block dimensions
-			blockSize = 0;
+		// fast seek ahead by fixed size for binary files
+		if (!sourceSkip(&file->source, (long)blockSize)) {
+			return false;
+		}
+	}
+	else {
+		// reset sizes of each property block
+		for (size_t p = 0; p < pCount; ++p) {
+			props[p].propertySize = 0;
+		}
+		// forward skips of varying length in case of non-fixed length
+		for (size_t i = 0; i < iCount; ++i) {
+			// skim through each property individually
 			for (size_t p = 0; p < pCount; ++p) {
 				prop = props[p];
-				prop.propertySize = (long)(elem.itemCount * PlyTypeSizes[prop.type]);
-				blockSize += prop.propertySize;
-				props[p] = prop;
-			}
-			// fast seek ahead by fixed size for binary files
-			fseek(file->file, (long)(blockSize), SEEK_CUR);
-		}
-		else {
-			// forward skips of varying length in case of non-fixed length
-			for (size_t i = 0; i < iCount; ++i) {
-				// skim through each property individually
-				for (size_t p = 0; p < pCount; ++p) {
-					prop = elem.properties[p];
-					itemSize = PlyTypeSizes[prop.type];
-					if (prop.listType != PlyType::NONE) {
-						// deal with list case
-						listTypeSize = PlyTypeSizes[prop.listType];
-						fread(&listElements, listTypeSize, 1, file->file);
-						prop.propertySize += (long)(listElements * itemSize);
-						fseek(file->file, (long)(listElements * itemSize), SEEK_CUR);
-					}
-					else {
-						// deal with non-list case
-						prop.propertySize += (long)itemSize;
-						fseek(file->file, (long)(itemSize), SEEK_CUR);
-					}
-					props[p] = prop;
+				itemSize = PlyTypeSizes[prop.type];
+				if (prop.listType != PlyType::NONE) {
+					// deal with list case
+					listTypeSize = PlyTypeSizes[prop.listType];
+					sourceRead(&file->source, listBuffer, listTypeSize);
+					listElements = readListLength(listBuffer, prop.listType, swap);
+					prop.propertySize += (long)(listElements * itemSize);
+					sourceSkip(&file->source, (long)(listElements * itemSize));
 				}
+				else {
+					// deal with non-list case
+					prop.propertySize += (long)itemSize;
+					sourceSkip(&file->source, (long)itemSize);
+				}
+				props[p] = prop;
 			}
 		}
-		dataStart = ftell(file->file);
-		file->elements[e] = elem;
 	}
+	// start of next element is known now
+	if (elemIdx + 1 < (size_t)file->elementCount) {
+		file->elements[elemIdx + 1].dataStart = sourceTell(&file->source);
+	}
+	return true;
 }
 
 void closePly(PlyFile* file) {
-	// close source file
-	fclose(file->file);
-	file->file = NULL;
+	// close source
+	closeSource(&file->source);
 	// free elements and properties
 	const size_t eCount = file->elementCount;
 	PlyElement* elems = file->elements;
@@ -407,33 +735,72 @@ void closePly(PlyFile* file) {
 	file->dataStart = 0;
 }
 
+/*
+* Arguments of element decoding tasks.
+*/
+struct PlyElementTask {
+	// files with own source views, one per element
+	PlyFile* files = NULL;
+	// names of elements
+	const char* const* names = NULL;
+	// success of each element
+	bool* results = NULL;
+};
+
+static void requestElementTask(void* args, size_t thread, size_t threads) {
+	PlyElementTask* task = (PlyElementTask*)args;
+	task->results[thread] = requestProperties(task->files + thread, task->names[thread], 0, NULL);
+	(void)threads;
+}
+
 bool requestElement(PlyFile* file, const char* name, size_t n, ...) {
+	// collect names of requested properties
+	const char** names = (const char**)malloc((n + 1) * sizeof(const char*));
+	va_list vl;
+	va_start(vl, n);
+	for (size_t i = 0; i < n; ++i) {
+		names[i] = va_arg(vl, const char*);
+	}
+	va_end(vl);
+	const bool success = requestProperties(file, name, n, names);
+	free(names);
+	return success;
+}
+
+bool requestProperties(PlyFile* file, const char* name, size_t n, const char* const* names) {
 	// get element index by name
-	int elemIdx = -1;
 	PlyElement elem;
-	const size_t elementCount = file->elementCount;
-	for (size_t i = 0; i < elementCount; ++i) {
-		elem = file->elements[i];
-		if (!strcmp(elem.name, name)) {
-			elemIdx = (int)i;
-			break;
-		}
-	}
+	const int elemIdx = findElement(file, name);
 	if (elemIdx == -1) {
 		// element name not found
 		return false;
 	}
+	// loaded items of compacted elements no longer match the items in file
+	if (file->elements[elemIdx].itemCount != file->elements[elemIdx].fileItemCount) {
+		return false;
+	}
+	// check if element block can still be reached
+	if (!seekElement(file, elemIdx)) {
+		return false;
+	}
+	elem = file->elements[elemIdx];
 	// get properties
-	const size_t eCount = elem.itemCount;
 	const size_t pCount = elem.propertyCount;
 	PlyProperty* props = elem.properties;
+	// replace quantized data by raw data, loaded properties are read again
+	for (size_t p = 0; p < pCount; ++p) {
+		if (props[p].dataQuantization != QUANT_NONE) {
+			// released components of normals are restored as well
+			free(props[p].data);
+			props[p].propertySize = (long)(elem.itemCount * PlyTypeSizes[props[p].type]);
+			props[p].data = malloc(props[p].propertySize);
+			props[p].dataQuantization = QUANT_NONE;
+		}
+	}
 	// allocate memory for requested properties
 	bool requestAll = !n;
 	PlyProperty prop;
 	int requestIdx;
-	char* requestName;
-	va_list vl;
-	va_start(vl, n);
 	if (requestAll) {
 		n = pCount;
 	}
@@ -443,20 +810,16 @@ bool requestElement(PlyFile* file, const char* name, size_t n, ...) {
 		requestIdx = (int)i;
 		if (!requestAll) {
 			// try find index of requested property
-			requestIdx = -1;
-			requestName = va_arg(vl, char*);
-			for (size_t p = 0; p < pCount; ++p) {
-				prop = props[p];
-				if (!strcmp(prop.name, requestName)) {
-					requestIdx = (int)p;
-					break;
-				}
-			}
+			requestIdx = findProperty(&elem, names[i]);
 		}
 		if (requestIdx != -1) {
 			// allocate memory of requested property
 			prop = props[requestIdx];
 			if (!prop.data) {
+				// estimate list sizes of uninspected elements
+				if (!prop.propertySize && (prop.listType != PlyType::NONE)) {
+					prop.propertySize = (long)(elem.itemCount * MUPLY_LIST_ESTIMATE * PlyTypeSizes[prop.type]);
+				}
 				// allocate raw data space
 				prop.data = malloc(prop.propertySize);
 			}
@@ -469,50 +832,1542 @@ bool requestElement(PlyFile* file, const char* name, size_t n, ...) {
 			++nAllocated;
 		}
 	}
-	va_end(vl);
-	// get endianness
-	const bool endianSys = isLittleEndian();
-	const bool endianData = (file->encoding == PlyEncoding::BINARY_LITTLE_ENDIAN);
-	const bool needByteSwap = (endianSys != endianData);
 	// forward to suitable read function
+	bool success = true;
 	if (nAllocated) {
 		switch (file->encoding) {
 		case PlyEncoding::ASCII:
-			readPropertiesAscii(file, elemIdx);
+			success = readPropertiesAscii(file, elemIdx);
 			break;
 		case PlyEncoding::BINARY_LITTLE_ENDIAN:
 		case PlyEncoding::BINARY_BIG_ENDIAN:
-			readPropertiesBinary(file, elemIdx);
-			//byteswap data if necessary
-			if (needByteSwap) {
-				byteSwapProperties(file, elemIdx);
-			}
+			// byteswaps are performed while decoding
+			success = readPropertiesBinary(file, elemIdx);
 			break;
 		default:
 			break;
 		}
 	}
-	return true;
+	if (success && nAllocated) {
+		quantizeProperties(file, elemIdx);
+	}
+	return success;
 }
 
-void readPropertiesAscii(PlyFile* file, const size_t elemIdx) {
-	// setup properties and jump to element block
-	PlyElement elem = file->elements[elemIdx];
-	PlyProperty* props = elem.properties;
-	const size_t iCount = elem.itemCount;
-	const size_t pCount = elem.propertyCount;
-	fseek(file->file, elem.dataStart, SEEK_SET);
-	// allocate buffer for reading
-	char buffer[MUPLY_BUFFER_SIZE];
-	// setup position indices for the properties
-	for (size_t p = 0; p < pCount; ++p) {
-		props[p].propertySize = 0;
+bool requestElements(PlyFile* file, const size_t n, const char* const* names) {
+	// get element indices and make sure their element blocks are known
+	int* elemIdx = (int*)malloc((n + 1) * sizeof(int));
+	bool success = true;
+	for (size_t i = 0; i < n && success; ++i) {
+		elemIdx[i] = findElement(file, names[i]);
+		success = (elemIdx[i] != -1);
 	}
-	// setup properties
-	char* token;
-	size_t itemSize;
-	int listElements, pIdx;
-	int8_t* data;
+	// forward-only sources and sources without positioned reads load elements one after another
+	PlySource* source = &file->source;
+	if (!success || n < 2 || !sourceSeekable(source) || (source->read && !source->readAt)) {
+		for (size_t i = 0; i < n && success; ++i) {
+			success = requestProperties(file, names[i], 0, NULL);
+		}
+		free(elemIdx);
+		return success;
+	}
+	for (size_t i = 0; i < n && success; ++i) {
+		success = seekElement(file, elemIdx[i]);
+	}
+	// setup files with their own source views and element copies
+	PlyElementTask task;
+	task.files = (PlyFile*)malloc(n * sizeof(PlyFile));
+	for (size_t i = 0; i < n; ++i) {
+		task.files[i] = PlyFile();
+	}
+	task.names = names;
+	task.results = (bool*)calloc(n, sizeof(bool));
+	const size_t threads = resolveThreadCount(file->threadCount);
+	long totalSize = 0;
+	long* sizes = (long*)malloc((n + 1) * sizeof(long));
+	for (size_t i = 0; i < n && success; ++i) {
+		// estimate decoded bytes by item and list counts, the last element block has no known end
+		const PlyElement* elem = file->elements + elemIdx[i];
+		sizes[i] = 0;
+		for (size_t p = 0; p < elem->propertyCount; ++p) {
+			const PlyProperty* prop = elem->properties + p;
+			if (prop->listType == PlyType::NONE) {
+				sizes[i] += (long)(elem->fileItemCount * PlyTypeSizes[prop->type]);
+			}
+			else {
+				sizes[i] += (long)(elem->fileItemCount * PlyTypeSizes[prop->listType]);
+				sizes[i] += prop->propertySize ? prop->propertySize : (long)(elem->fileItemCount * MUPLY_LIST_ESTIMATE * PlyTypeSizes[prop->type]);
+			}
+		}
+		totalSize += sizes[i];
+	}
+	for (size_t i = 0; i < n && success; ++i) {
+		PlyFile* view = task.files + i;
+		*view = *file;
+		view->elements = (PlyElement*)malloc(file->elementCount * sizeof(PlyElement));
+		memcpy((void*)view->elements, file->elements, file->elementCount * sizeof(PlyElement));
+		view->source = PlySource();
+		view->source.kind = source->kind;
+		if (source->read) {
+			PlySourceView* handle = (PlySourceView*)malloc(sizeof(PlySourceView));
+			handle->base = source;
+			handle->offset = 0;
+			view->source.handle = handle;
+			view->source.read = readView;
+			view->source.seek = seekView;
+			view->source.readAt = readAtView;
+			view->source.close = closeView;
+		}
+		else {
+			view->source.buffer = source->buffer;
+			view->source.bufferSize = source->bufferSize;
+			view->source.bufferFill = source->bufferFill;
+		}
+		initSource(&view->source);
+		// share threads by the estimated sizes of elements
+		const size_t share = (totalSize && sizes[i]) ? (size_t)((double)threads * (double)sizes[i] / (double)totalSize + 0.5) : threads / n;
+		view->threadCount = (int)(share ? share : 1);
+	}
+	free(sizes);
+	// decode each element on its own worker
+	if (success) {
+		runParallel(requestElementTask, &task, n);
+		for (size_t i = 0; i < n; ++i) {
+			success &= task.results[i];
+		}
+	}
+	for (size_t i = 0; i < n; ++i) {
+		closeSource(&task.files[i].source);
+		free(task.files[i].elements);
+	}
+	free(task.files);
+	free(task.results);
+	free(elemIdx);
+	return success;
+}
+
+bool seekElement(PlyFile* file, const int elemIdx) {
+	// skip through preceding elements of forward-only sources in file order
+	for (int e = 0; e < elemIdx && !file->elements[elemIdx].dataStart; ++e) {
+		if (!file->elements[e + 1].dataStart && !inspectElement(file, e)) {
+			return false;
+		}
+	}
+	return sourceSeek(&file->source, file->elements[elemIdx].dataStart);
+}
+
+bool streamElement(PlyFile* file, const char* name, const size_t batchSize, bool (*callback)(const PlyBatch* batch, void* user), void* user) {
+	return streamRecords(file, name, batchSize, false, callback, user);
+}
+
+bool streamRecords(PlyFile* file, const char* name, const size_t batchSize, const bool fileOrder, bool (*callback)(const PlyBatch* batch, void* user), void* user) {
+	const int elemIdx = findElement(file, name);
+	if (elemIdx == -1 || !batchSize || !seekElement(file, elemIdx)) {
+		return false;
+	}
+	// forward to suitable streaming function
+	bool success = false;
+	switch (file->encoding) {
+	case PlyEncoding::ASCII:
+		success = streamElementAscii(file, elemIdx, batchSize, callback, user);
+		break;
+	case PlyEncoding::BINARY_LITTLE_ENDIAN:
+	case PlyEncoding::BINARY_BIG_ENDIAN:
+		success = streamElementBinary(file, elemIdx, batchSize, fileOrder, callback, user);
+		break;
+	default:
+		break;
+	}
+	// start of next element is known now
+	if (success && elemIdx + 1 < file->elementCount) {
+		file->elements[elemIdx + 1].dataStart = sourceTell(&file->source);
+	}
+	return success;
+}
+
+bool streamElementBinary(PlyFile* file, const size_t elemIdx, const size_t batchSize, const bool fileOrder, bool (*callback)(const PlyBatch* batch, void* user), void* user) {
+	const PlyElement elem = file->elements[elemIdx];
+	const PlyProperty* props = elem.properties;
+	const size_t pCount = elem.propertyCount;
+	const size_t iCount = elem.fileItemCount;
+	const bool swap = requiresByteSwap(file);
+	PlySource* source = &file->source;
+	// get size of fixed-size items
+	bool fixedLength = true;
+	size_t stride = 0;
+	for (size_t p = 0; p < pCount; ++p) {
+		stride += PlyTypeSizes[props[p].type];
+		fixedLength &= (props[p].listType == PlyType::NONE);
+	}
+	size_t* offsets = (size_t*)malloc((batchSize + 1) * sizeof(size_t));
+	char* swapBuffer = NULL;
+	size_t swapCapacity = 0;
+	size_t chunkSize = fixedLength ? batchSize * stride : MUPLY_CHUNK_SIZE;
+	size_t item = 0;
+	size_t available, count, end, listTypeSize;
+	int64_t listElements;
+	const char* items;
+	PlyBatch batch;
+	bool success = true;
+	while (item < iCount) {
+		// index complete items in source buffer
+		available = sourceEnsure(source, chunkSize);
+		items = source->buffer + source->bufferPos;
+		count = 0;
+		offsets[0] = 0;
+		while (count < batchSize && item + count < iCount) {
+			end = offsets[count];
+			if (fixedLength) {
+				end += stride;
+			}
+			else {
+				for (size_t p = 0; p < pCount && end <= available; ++p) {
+					listElements = 1;
+					if (props[p].listType != PlyType::NONE) {
+						listTypeSize = PlyTypeSizes[props[p].listType];
+						if (end + listTypeSize > available) {
+							end = available + 1;
+							break;
+						}
+						listElements = readListLength(items + end, props[p].listType, swap);
+						end += listTypeSize;
+					}
+					end += (size_t)listElements * PlyTypeSizes[props[p].type];
+				}
+			}
+			if (end > available) {
+				break;
+			}
+			offsets[++count] = end;
+		}
+		if (!count) {
+			// grow chunk for oversized items or stop at the end of data
+			if (available < chunkSize) {
+				success = false;
+				break;
+			}
+			chunkSize *= 2;
+			continue;
+		}
+		// byteswap a copy of the items if necessary
+		if (swap && !fileOrder) {
+			if (offsets[count] > swapCapacity) {
+				swapCapacity = offsets[count];
+				swapBuffer = (char*)realloc(swapBuffer, swapCapacity);
+			}
+			memcpy(swapBuffer, items, offsets[count]);
+			byteSwapItems(swapBuffer, count, &elem, false);
+			items = swapBuffer;
+		}
+		batch.items = items;
+		batch.offsets = offsets;
+		batch.itemCount = count;
+		batch.firstItem = item;
+		source->bufferPos += offsets[count];
+		item += count;
+		if (!callback(&batch, user)) {
+			success = false;
+			break;
+		}
+	}
+	free(offsets);
+	free(swapBuffer);
+	return success;
+}
+
+bool streamElementAscii(PlyFile* file, const size_t elemIdx, const size_t batchSize, bool (*callback)(const PlyBatch* batch, void* user), void* user) {
+	const PlyElement elem = file->elements[elemIdx];
+	const PlyProperty* props = elem.properties;
+	const size_t pCount = elem.propertyCount;
+	const size_t iCount = elem.fileItemCount;
+	PlySource* source = &file->source;
+	// setup buffers for packed items
+	size_t* offsets = (size_t*)malloc((batchSize + 1) * sizeof(size_t));
+	size_t capacity = MUPLY_BUFFER_SIZE * batchSize;
+	char* items = (char*)malloc(capacity);
+	char token[MUPLY_TOKEN_SIZE];
+	char listBuffer[sizeof(int64_t)];
+	size_t count = 0;
+	size_t item = 0;
+	size_t chunkSize = MUPLY_CHUNK_SIZE;
+	size_t lines, used, skipped, tokens, consumed, required, end, listTypeSize;
+	int64_t listElements;
+	const char *pos, *lineEnd, *tokenEnd;
+	PlyBatch batch;
+	bool success = true;
+	offsets[0] = 0;
+	// parse staged chunks of complete lines
+	while (item < iCount && success) {
+		lines = stageLines(source, iCount - item, &chunkSize, &used);
+		if (!lines) {
+			success = false;
+			break;
+		}
+		pos = source->buffer + source->bufferPos;
+		for (size_t l = 0; l < lines && success; ++l, ++item) {
+			skipped = 1;
+			lineEnd = findLines(pos, source->buffer + source->bufferPos + used - pos, &skipped);
+			// bound packed item by the tokens of the line, missing tokens yield one value per property
+			tokens = 0;
+			for (tokenEnd = skipSpaces(pos, lineEnd); tokenEnd < lineEnd && *tokenEnd != '\n'; tokenEnd = skipSpaces(tokenEnd, lineEnd)) {
+				tokenEnd = skipToken(tokenEnd, lineEnd);
+				++tokens;
+			}
+			end = offsets[count];
+			required = end + (tokens + pCount) * sizeof(int64_t);
+			if (required > capacity) {
+				capacity = 2 * capacity + required;
+				items = (char*)realloc(items, capacity);
+			}
+			consumed = 0;
+			for (size_t p = 0; p < pCount && success; ++p) {
+				listElements = 1;
+				if (props[p].listType != PlyType::NONE) {
+					pos = skipSpaces(pos, lineEnd);
+					tokenEnd = skipToken(pos, lineEnd);
+					listTypeSize = parseValue(copyToken(pos, tokenEnd, token), props[p].listType, listBuffer);
+					listElements = readListLength(listBuffer, props[p].listType, false);
+					memcpy(items + end, listBuffer, listTypeSize);
+					end += listTypeSize;
+					consumed += (tokenEnd != pos);
+					pos = tokenEnd;
+					// list entries have to be present on the line
+					if (listElements < 0 || (size_t)listElements > tokens - consumed) {
+						success = false;
+						break;
+					}
+				}
+				for (int64_t e = 0; e < listElements; ++e) {
+					pos = skipSpaces(pos, lineEnd);
+					tokenEnd = skipToken(pos, lineEnd);
+					end += parseValue(copyToken(pos, tokenEnd, token), props[p].type, items + end);
+					consumed += (tokenEnd != pos);
+					pos = tokenEnd;
+				}
+			}
+			pos = lineEnd;
+			if (!success) {
+				break;
+			}
+			offsets[++count] = end;
+			// pass full batches
+			if (count == batchSize || item + 1 == iCount) {
+				batch.items = items;
+				batch.offsets = offsets;
+				batch.itemCount = count;
+				batch.firstItem = item + 1 - count;
+				success = callback(&batch, user);
+				count = 0;
+			}
+		}
+		source->bufferPos += used;
+	}
+	free(offsets);
+	free(items);
+	return success;
+}
+
+size_t parseValue(const char* token, const PlyType type, char* dst) {
+	int8_t val8i; int16_t val16i; int32_t val32i; int64_t val64i;
+	uint8_t val8u; uint16_t val16u; uint32_t val32u; uint64_t val64u;
+	float val32f; double val64f;
+	switch (type) {
+	case PlyType::INT8:
+		val8i = (int8_t)strtol(token, NULL, 10);
+		memcpy(dst, &val8i, sizeof(val8i));
+		break;
+	case PlyType::INT16:
+		val16i = (int16_t)strtol(token, NULL, 10);
+		memcpy(dst, &val16i, sizeof(val16i));
+		break;
+	case PlyType::INT32:
+		val32i = (int32_t)strtol(token, NULL, 10);
+		memcpy(dst, &val32i, sizeof(val32i));
+		break;
+	case PlyType::INT64:
+		val64i = (int64_t)strtoll(token, NULL, 10);
+		memcpy(dst, &val64i, sizeof(val64i));
+		break;
+	case PlyType::UINT8:
+		val8u = (uint8_t)strtoul(token, NULL, 10);
+		memcpy(dst, &val8u, sizeof(val8u));
+		break;
+	case PlyType::UINT16:
+		val16u = (uint16_t)strtoul(token, NULL, 10);
+		memcpy(dst, &val16u, sizeof(val16u));
+		break;
+	case PlyType::UINT32:
+		val32u = (uint32_t)strtoul(token, NULL, 10);
+		memcpy(dst, &val32u, sizeof(val32u));
+		break;
+	case PlyType::UINT64:
+		val64u = (uint64_t)strtoull(token, NULL, 10);
+		memcpy(dst, &val64u, sizeof(val64u));
+		break;
+	case PlyType::FLOAT32:
+		val32f = strtof(token, NULL);
+		memcpy(dst, &val32f, sizeof(val32f));
+		break;
+	case PlyType::FLOAT64:
+		val64f = strtod(token, NULL);
+		memcpy(dst, &val64f, sizeof(val64f));
+		break;
+	default:
+		break;
+	}
+	return PlyTypeSizes[type];
+}
+
+void byteSwapItems(char* items, const size_t count, const PlyElement* elem, const bool nativeLengths) {
+	const PlyProperty* props = elem->properties;
+	const size_t pCount = elem->propertyCount;
+	size_t listTypeSize, itemSize;
+	int64_t listElements;
+	// records are packed, so values are swapped through aligned copies
+	uint64_t val;
+	char* pos = items;
+	for (size_t i = 0; i < count; ++i) {
+		for (size_t p = 0; p < pCount; ++p) {
+			listElements = 1;
+			if (props[p].listType != PlyType::NONE) {
+				listTypeSize = PlyTypeSizes[props[p].listType];
+				listElements = readListLength(pos, props[p].listType, !nativeLengths);
+				decodeValues(pos, listTypeSize, 1, (char*)&val, listTypeSize, true);
+				memcpy(pos, &val, listTypeSize);
+				pos += listTypeSize;
+			}
+			itemSize = PlyTypeSizes[props[p].type];
+			for (int64_t l = 0; l < listElements; ++l) {
+				decodeValues(pos, itemSize, 1, (char*)&val, itemSize, true);
+				memcpy(pos, &val, itemSize);
+				pos += itemSize;
+			}
+		}
+	}
+}
+
+double getItemValue(const char* item, const PlyElement* elem, const size_t propIdx) {
+	// walk preceding properties of record
+	const PlyProperty* props = elem->properties;
+	for (size_t p = 0; p < propIdx; ++p) {
+		if (props[p].listType != PlyType::NONE) {
+			const int64_t listElements = readListLength(item, props[p].listType, false);
+			item += PlyTypeSizes[props[p].listType] + (size_t)listElements * PlyTypeSizes[props[p].type];
+		}
+		else {
+			item += PlyTypeSizes[props[p].type];
+		}
+	}
+	// copy value to satisfy alignment
+	uint64_t val;
+	memcpy(&val, item, PlyTypeSizes[props[propIdx].type]);
+	return getValue((const char*)&val, props[propIdx].type, 0);
+}
+
+bool writeHeader(FILE* out, const PlyElement* elements, const size_t elementCount, const PlyEncoding encoding, long* countOffsets) {
+	fprintf(out, "ply\nformat %s 1.0\n", PlyEncodingStrings[encoding]);
+	PlyProperty prop;
+	for (size_t e = 0; e < elementCount; ++e) {
+		fprintf(out, "element %s ", elements[e].name);
+		// reserve space for updating counts in place
+		if (countOffsets) {
+			countOffsets[e] = ftell(out);
+			fprintf(out, "%-*zu\n", MUPLY_COUNT_WIDTH, elements[e].itemCount);
+		}
+		else {
+			fprintf(out, "%zu\n", elements[e].itemCount);
+		}
+		for (size_t p = 0; p < elements[e].propertyCount; ++p) {
+			prop = elements[e].properties[p];
+			if (prop.listType != PlyType::NONE) {
+				fprintf(out, "property list %s %s %s\n", PlyTypeStrings[prop.listType], PlyTypeStrings[prop.type], prop.name);
+			}
+			else {
+				fprintf(out, "property %s %s\n", PlyTypeStrings[prop.type], prop.name);
+			}
+		}
+	}
+	fprintf(out, "end_header\n");
+	return !ferror(out);
+}
+
+bool updateItemCount(FILE* out, const long countOffset, const size_t count) {
+	if (fseek(out, countOffset, SEEK_SET)) {
+		return false;
+	}
+	fprintf(out, "%-*zu", MUPLY_COUNT_WIDTH, count);
+	return !ferror(out);
+}
+
+/*
+* Buffered writer of a single tile.
+*/
+struct PlyTileWriter {
+	// buffered item records
+	char* buffer = NULL;
+	// number of buffered bytes
+	size_t fill = 0;
+	// number of items written to tile
+	size_t itemCount = 0;
+	// true, if tile file was created
+	bool created = false;
+	// file offset of item count
+	long countOffset = 0;
+};
+
+/*
+* State of a tiling run.
+*/
+struct PlyTilingState {
+	// tiling settings
+	const PlyTiling* tiling = NULL;
+	// tiled element
+	const PlyElement* elem = NULL;
+	// indices of coordinate properties
+	size_t coords[3] = { 0, 0, 0 };
+	// bounds of grid
+	double min[3] = { HUGE_VAL, HUGE_VAL, HUGE_VAL };
+	double max[3] = { -HUGE_VAL, -HUGE_VAL, -HUGE_VAL };
+	// tile writers
+	PlyTileWriter* writers = NULL;
+	// size of write buffer per tile
+	size_t bufferSize = 0;
+	// set if writing failed
+	bool failed = false;
+};
+
+static bool accumulateBounds(const PlyBatch* batch, void* user) {
+	PlyTilingState* state = (PlyTilingState*)user;
+	double val;
+	for (size_t i = 0; i < batch->itemCount; ++i) {
+		for (int c = 0; c < 3; ++c) {
+			val = getItemValue(batch->items + batch->offsets[i], state->elem, state->coords[c]);
+			state->min[c] = (val < state->min[c]) ? val : state->min[c];
+			state->max[c] = (val > state->max[c]) ? val : state->max[c];
+		}
+	}
+	return true;
+}
+
+static bool flushTile(PlyTilingState* state, const size_t tileIdx) {
+	PlyTileWriter* writer = state->writers + tileIdx;
+	const size_t* tiles = state->tiling->tiles;
+	char path[4096];
+	snprintf(path, sizeof(path), state->tiling->pattern, tileIdx % tiles[0], (tileIdx / tiles[0]) % tiles[1], tileIdx / (tiles[0] * tiles[1]));
+	// create tile with header on first flush
+	FILE* out = fopen(path, writer->created ? "ab" : "wb");
+	if (!out) {
+		return false;
+	}
+	bool success = true;
+	if (!writer->created) {
+		PlyElement elem = *state->elem;
+		const PlyEncoding encoding = isLittleEndian() ? PlyEncoding::BINARY_LITTLE_ENDIAN : PlyEncoding::BINARY_BIG_ENDIAN;
+		success = writeHeader(out, &elem, 1, encoding, &writer->countOffset);
+		writer->created = true;
+	}
+	success &= (fwrite(writer->buffer, 1, writer->fill, out) == writer->fill);
+	success &= !fclose(out);
+	writer->fill = 0;
+	return success;
+}
+
+static bool binItems(const PlyBatch* batch, void* user) {
+	PlyTilingState* state = (PlyTilingState*)user;
+	const size_t* tiles = state->tiling->tiles;
+	const char* item;
+	size_t itemSize, tileIdx, cell;
+	double val;
+	PlyTileWriter* writer;
+	for (size_t i = 0; i < batch->itemCount; ++i) {
+		// get tile of item, clamp to border tiles
+		item = batch->items + batch->offsets[i];
+		itemSize = batch->offsets[i + 1] - batch->offsets[i];
+		tileIdx = 0;
+		for (int c = 2; c >= 0; --c) {
+			val = getItemValue(item, state->elem, state->coords[c]);
+			val = (state->max[c] > state->min[c]) ? (val - state->min[c]) / (state->max[c] - state->min[c]) * (double)tiles[c] : 0.0;
+			cell = (val > 0.0) ? ((val < (double)tiles[c]) ? (size_t)val : tiles[c] - 1) : 0;
+			tileIdx = tileIdx * tiles[c] + cell;
+		}
+		// append record to tile buffer
+		writer = state->writers + tileIdx;
+		if (!writer->buffer) {
+			writer->buffer = (char*)malloc(state->bufferSize);
+		}
+		if (writer->fill + itemSize > state->bufferSize && writer->fill) {
+			if (!flushTile(state, tileIdx)) {
+				state->failed = true;
+				return false;
+			}
+		}
+		if (itemSize > state->bufferSize) {
+			// write oversized items through a temporary buffer
+			char* buffer = writer->buffer;
+			writer->buffer = (char*)item;
+			writer->fill = itemSize;
+			const bool success = flushTile(state, tileIdx);
+			writer->buffer = buffer;
+			if (!success) {
+				state->failed = true;
+				return false;
+			}
+		}
+		else {
+			memcpy(writer->buffer + writer->fill, item, itemSize);
+			writer->fill += itemSize;
+		}
+		++writer->itemCount;
+	}
+	return true;
+}
+
+bool tilePly(const char* path, const PlyTiling* tiling) {
+	PlyTilingState state;
+	state.tiling = tiling;
+	const size_t tileCount = tiling->tiles[0] * tiling->tiles[1] * tiling->tiles[2];
+	if (!tileCount) {
+		return false;
+	}
+	// get bounds in a first pass if necessary
+	PlyFile pfile = probePly(path);
+	const int elemIdx = findElement(&pfile, tiling->element);
+	bool success = (elemIdx != -1);
+	for (int c = 0; c < 3 && success; ++c) {
+		const int propIdx = findProperty(pfile.elements + elemIdx, tiling->coords[c]);
+		success = (propIdx != -1) && (pfile.elements[elemIdx].properties[propIdx].listType == PlyType::NONE);
+		state.coords[c] = (size_t)propIdx;
+		state.min[c] = tiling->min[c];
+		state.max[c] = tiling->max[c];
+	}
+	closePly(&pfile);
+	if (!success) {
+		return false;
+	}
+	// passes only parse the header and skip through preceding elements
+	PlySource source;
+	long dataStart = 0;
+	if (!tiling->hasBounds) {
+		for (int c = 0; c < 3; ++c) {
+			state.min[c] = HUGE_VAL;
+			state.max[c] = -HUGE_VAL;
+		}
+		pfile = openFileSource(path, &source) ? openPlyHeader(source) : PlyFile();
+		state.elem = pfile.elements + elemIdx;
+		success = pfile.elementCount && streamElement(&pfile, tiling->element, tiling->batchSize, accumulateBounds, &state);
+		dataStart = success ? pfile.elements[elemIdx].dataStart : 0;
+		closePly(&pfile);
+	}
+	// bin items into tiles in a second pass, starting at the element block found by the first pass
+	if (success) {
+		pfile = openFileSource(path, &source) ? openPlyHeader(source) : PlyFile();
+		if (pfile.elementCount && dataStart) {
+			pfile.elements[elemIdx].dataStart = dataStart;
+		}
+		state.elem = pfile.elements + elemIdx;
+		state.writers = (PlyTileWriter*)calloc(tileCount, sizeof(PlyTileWriter));
+		state.bufferSize = tiling->bufferMemory / tileCount;
+		state.bufferSize = (state.bufferSize > MUPLY_BUFFER_SIZE) ? state.bufferSize : MUPLY_BUFFER_SIZE;
+		success = pfile.elementCount && streamElement(&pfile, tiling->element, tiling->batchSize, binItems, &state);
+		// flush remaining items and update item counts
+		for (size_t t = 0; t < tileCount && success; ++t) {
+			PlyTileWriter* writer = state.writers + t;
+			if (writer->fill) {
+				success = flushTile(&state, t);
+			}
+			if (writer->created && success) {
+				char tilePath[4096];
+				snprintf(tilePath, sizeof(tilePath), tiling->pattern, t % tiling->tiles[0], (t / tiling->tiles[0]) % tiling->tiles[1], t / (tiling->tiles[0] * tiling->tiles[1]));
+				FILE* out = fopen(tilePath, "r+b");
+				success = out && updateItemCount(out, writer->countOffset, writer->itemCount);
+				success &= out && !fclose(out);
+			}
+		}
+		for (size_t t = 0; t < tileCount; ++t) {
+			free(state.writers[t].buffer);
+		}
+		free(state.writers);
+		closePly(&pfile);
+	}
+	return success && !state.failed;
+}
+
+/*
+* State of a transcoding run for a single element.
+*/
+struct PlyTranscodeState {
+	// target file
+	FILE* out = NULL;
+	// encoding of target file
+	PlyEncoding encoding = PlyEncoding::UNKNOWN;
+	// source element
+	const PlyElement* elem = NULL;
+	// target element with kept properties
+	const PlyElement* target = NULL;
+	// flags of kept properties
+	const bool* keep = NULL;
+	// true, if all properties are kept
+	bool keepAll = true;
+	// true, if records are streamed in the byte order of the source, which equals the target encoding
+	bool fileOrder = false;
+	// index of list property holding item indices, -1 if none
+	int indexProperty = -1;
+	// offset added to item indices
+	int64_t indexOffset = 0;
+	// buffer for converted items
+	char* buffer = NULL;
+	size_t capacity = 0;
+};
+
+static bool transcodeItems(const PlyBatch* batch, void* user) {
+	PlyTranscodeState* state = (PlyTranscodeState*)user;
+	const PlyProperty* props = state->elem->properties;
+	const size_t pCount = state->elem->propertyCount;
+	const size_t batchSize = batch->offsets[batch->itemCount];
+	const bool ascii = (state->encoding == PlyEncoding::ASCII);
+	const bool swap = !ascii && (isLittleEndian() != (state->encoding == PlyEncoding::BINARY_LITTLE_ENDIAN));
+	const bool offset = (state->indexProperty != -1 && state->indexOffset);
+	// write records of matching byte order in one block
+	if (state->fileOrder || (!ascii && !swap && state->keepAll && !offset)) {
+		return (fwrite(batch->items, 1, batchSize, state->out) == batchSize);
+	}
+	// ascii tokens with separator take at most five characters per binary byte
+	const size_t required = ascii ? 5 * batchSize + batch->itemCount : batchSize;
+	if (required > state->capacity) {
+		state->capacity = required;
+		state->buffer = (char*)realloc(state->buffer, state->capacity);
+	}
+	const char* pos;
+	char* dst = state->buffer;
+	size_t valueSize, listTypeSize;
+	int64_t listElements;
+	uint64_t val;
+	for (size_t i = 0; i < batch->itemCount; ++i) {
+		pos = batch->items + batch->offsets[i];
+		for (size_t p = 0; p < pCount; ++p) {
+			listElements = 1;
+			listTypeSize = 0;
+			if (props[p].listType != PlyType::NONE) {
+				listTypeSize = PlyTypeSizes[props[p].listType];
+				listElements = readListLength(pos, props[p].listType, false);
+			}
+			valueSize = PlyTypeSizes[props[p].type];
+			if (!state->keep[p]) {
+				pos += listTypeSize + (size_t)listElements * valueSize;
+				continue;
+			}
+			if (!ascii) {
+				memcpy(dst, pos, listTypeSize + (size_t)listElements * valueSize);
+				if (offset && (int)p == state->indexProperty) {
+					offsetValues(dst + listTypeSize, props[p].type, (size_t)listElements, state->indexOffset);
+				}
+				dst += listTypeSize + (size_t)listElements * valueSize;
+				pos += listTypeSize + (size_t)listElements * valueSize;
+				continue;
+			}
+			if (listTypeSize) {
+				dst += formatValue(pos, props[p].listType, dst);
+				*(dst++) = ' ';
+				pos += listTypeSize;
+			}
+			for (int64_t l = 0; l < listElements; ++l) {
+				memcpy(&val, pos, valueSize);
+				if (offset && (int)p == state->indexProperty) {
+					offsetValues((char*)&val, props[p].type, 1, state->indexOffset);
+				}
+				dst += formatValue((const char*)&val, props[p].type, dst);
+				*(dst++) = ' ';
+				pos += valueSize;
+			}
+		}
+		if (ascii) {
+			// replace trailing separator by line break
+			if (dst > state->buffer && dst[-1] == ' ') {
+				--dst;
+			}
+			*(dst++) = '\n';
+		}
+	}
+	if (swap) {
+		byteSwapItems(state->buffer, batch->itemCount, state->target, true);
+	}
+	const size_t written = dst - state->buffer;
+	return (fwrite(state->buffer, 1, written, state->out) == written);
+}
+
+bool transcodePly(PlyFile* file, FILE* out, const PlyEncoding encoding, const size_t n, const char* const* properties) {
+	if (!file->elementCount || !out || encoding == PlyEncoding::UNKNOWN) {
+		return false;
+	}
+	// collect kept properties of all elements
+	const size_t eCount = file->elementCount;
+	PlyElement* targets = (PlyElement*)malloc(eCount * sizeof(PlyElement));
+	for (size_t e = 0; e < eCount; ++e) {
+		targets[e] = PlyElement();
+	}
+	size_t targetCount = 0;
+	bool** keep = (bool**)malloc(eCount * sizeof(bool*));
+	int* targetIdx = (int*)malloc(eCount * sizeof(int));
+	for (size_t e = 0; e < eCount; ++e) {
+		const PlyElement elem = file->elements[e];
+		keep[e] = (bool*)malloc((elem.propertyCount + 1) * sizeof(bool));
+		PlyElement* target = targets + targetCount;
+		target->name = elem.name;
+		target->itemCount = elem.fileItemCount;
+		target->properties = (PlyProperty*)malloc((elem.propertyCount + 1) * sizeof(PlyProperty));
+		for (size_t p = 0; p < elem.propertyCount; ++p) {
+			target->properties[p] = PlyProperty();
+		}
+		for (size_t p = 0; p < elem.propertyCount; ++p) {
+			keep[e][p] = !n;
+			for (size_t k = 0; k < n && !keep[e][p]; ++k) {
+				keep[e][p] = !strcmp(elem.properties[p].name, properties[k]);
+			}
+			if (keep[e][p]) {
+				target->properties[target->propertyCount].name = elem.properties[p].name;
+				target->properties[target->propertyCount].type = elem.properties[p].type;
+				target->properties[target->propertyCount].listType = elem.properties[p].listType;
+				++target->propertyCount;
+			}
+		}
+		targetIdx[e] = target->propertyCount ? (int)targetCount++ : -1;
+		if (targetIdx[e] == -1) {
+			free(target->properties);
+			*target = PlyElement();
+		}
+	}
+	// write header and stream elements in file order
+	bool success = writeHeader(out, targets, targetCount, encoding);
+	PlyTranscodeState state;
+	state.out = out;
+	state.encoding = encoding;
+	for (size_t e = 0; e < eCount && success; ++e) {
+		if (targetIdx[e] == -1) {
+			continue;
+		}
+		state.elem = file->elements + e;
+		state.target = targets + targetIdx[e];
+		state.keep = keep[e];
+		state.keepAll = (state.target->propertyCount == state.elem->propertyCount);
+		// unchanged binary records are passed through without byteswapping
+		state.fileOrder = state.keepAll && encoding != PlyEncoding::ASCII && encoding == file->encoding;
+		success = streamRecords(file, file->elements[e].name, MUPLY_CHUNK_SIZE / MUPLY_BUFFER_SIZE, state.fileOrder, transcodeItems, &state);
+	}
+	// cleanup, names are borrowed from the source file
+	for (size_t e = 0; e < eCount; ++e) {
+		free(keep[e]);
+		free(targets[e].properties);
+	}
+	free(targets);
+	free(keep);
+	free(targetIdx);
+	free(state.buffer);
+	return success && !ferror(out);
+}
+
+bool compatiblePly(const PlyFile* file, const PlyFile* other) {
+	if (file->elementCount != other->elementCount) {
+		return false;
+	}
+	PlyElement elem, otherElem;
+	for (int e = 0; e < file->elementCount; ++e) {
+		elem = file->elements[e];
+		otherElem = other->elements[e];
+		if (strcmp(elem.name, otherElem.name) || elem.propertyCount != otherElem.propertyCount) {
+			return false;
+		}
+		for (size_t p = 0; p < elem.propertyCount; ++p) {
+			if (strcmp(elem.properties[p].name, otherElem.properties[p].name)
+				|| elem.properties[p].type != otherElem.properties[p].type
+				|| elem.properties[p].listType != otherElem.properties[p].listType) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+bool mergePly(const char* const* paths, const size_t pathCount, FILE* out, const PlyEncoding encoding, const char* indexElement, const char* indexProperty) {
+	if (!pathCount || !out || encoding == PlyEncoding::UNKNOWN) {
+		return false;
+	}
+	// check schemas and collect item counts from headers
+	PlyFile schema = probePly(paths[0]);
+	const size_t eCount = schema.elementCount;
+	bool success = (eCount > 0);
+	size_t* itemCounts = (size_t*)calloc(pathCount * eCount + 1, sizeof(size_t));
+	long* dataStarts = (long*)calloc(pathCount * eCount + 1, sizeof(long));
+	PlySource source;
+	PlyFile pfile;
+	for (size_t f = 0; f < pathCount && success; ++f) {
+		pfile = probePly(paths[f]);
+		success = compatiblePly(&schema, &pfile);
+		for (size_t e = 0; e < eCount && success; ++e) {
+			itemCounts[f * eCount + e] = pfile.elements[e].itemCount;
+			schema.elements[e].itemCount += f ? pfile.elements[e].itemCount : 0;
+		}
+		closePly(&pfile);
+	}
+	// write header with summed item counts
+	success = success && writeHeader(out, schema.elements, eCount, encoding);
+	// stream element payloads of all files in element order
+	const int indexElemIdx = success ? findElement(&schema, indexElement) : -1;
+	bool* keep = NULL;
+	PlyTranscodeState state;
+	state.out = out;
+	state.encoding = encoding;
+	for (size_t e = 0; e < eCount && success; ++e) {
+		state.target = schema.elements + e;
+		keep = (bool*)realloc(keep, (schema.elements[e].propertyCount + 1) * sizeof(bool));
+		for (size_t p = 0; p < schema.elements[e].propertyCount; ++p) {
+			keep[p] = true;
+		}
+		state.keep = keep;
+		state.indexProperty = -1;
+		if (indexElemIdx != -1 && indexProperty) {
+			state.indexProperty = findProperty(schema.elements + e, indexProperty);
+		}
+		state.indexOffset = 0;
+		for (size_t f = 0; f < pathCount && success; ++f) {
+			// reopen without inspection, element offsets are known from preceding passes
+			pfile = openFileSource(paths[f], &source) ? openPlyHeader(source) : PlyFile();
+			success = compatiblePly(&schema, &pfile);
+			for (size_t k = 1; k <= e && success; ++k) {
+				pfile.elements[k].dataStart = dataStarts[f * eCount + k];
+			}
+			if (success && itemCounts[f * eCount + e]) {
+				state.elem = pfile.elements + e;
+				// records without index offsets are passed through if byte orders match
+				state.fileOrder = encoding != PlyEncoding::ASCII && encoding == pfile.encoding &&
+					(state.indexProperty == -1 || !state.indexOffset);
+				success = streamRecords(&pfile, pfile.elements[e].name, MUPLY_CHUNK_SIZE / MUPLY_BUFFER_SIZE, state.fileOrder, transcodeItems, &state);
+			}
+			// streaming finds the start of the next element
+			if (success && e + 1 < eCount) {
+				dataStarts[f * eCount + e + 1] = itemCounts[f * eCount + e] ? pfile.elements[e + 1].dataStart : pfile.elements[e].dataStart;
+			}
+			closePly(&pfile);
+			// indices of following files refer to items behind those of preceding files
+			if (indexElemIdx != -1) {
+				state.indexOffset += (int64_t)itemCounts[f * eCount + indexElemIdx];
+			}
+		}
+	}
+	free(keep);
+	free(itemCounts);
+	free(dataStarts);
+	free(state.buffer);
+	closePly(&schema);
+	return success && !ferror(out);
+}
+
+void offsetValues(char* data, const PlyType type, const size_t count, const int64_t offset) {
+	// values may be unaligned within packed records
+	int8_t val8i; int16_t val16i; int32_t val32i; int64_t val64i;
+	uint8_t val8u; uint16_t val16u; uint32_t val32u; uint64_t val64u;
+	for (size_t i = 0; i < count; ++i) {
+		char* ptr = data + i * PlyTypeSizes[type];
+		switch (type) {
+		case PlyType::INT8:
+			memcpy(&val8i, ptr, sizeof(val8i));
+			val8i = (int8_t)(val8i + offset);
+			memcpy(ptr, &val8i, sizeof(val8i));
+			break;
+		case PlyType::INT16:
+			memcpy(&val16i, ptr, sizeof(val16i));
+			val16i = (int16_t)(val16i + offset);
+			memcpy(ptr, &val16i, sizeof(val16i));
+			break;
+		case PlyType::INT32:
+			memcpy(&val32i, ptr, sizeof(val32i));
+			val32i = (int32_t)(val32i + offset);
+			memcpy(ptr, &val32i, sizeof(val32i));
+			break;
+		case PlyType::INT64:
+			memcpy(&val64i, ptr, sizeof(val64i));
+			val64i = val64i + offset;
+			memcpy(ptr, &val64i, sizeof(val64i));
+			break;
+		case PlyType::UINT8:
+			memcpy(&val8u, ptr, sizeof(val8u));
+			val8u = (uint8_t)(val8u + offset);
+			memcpy(ptr, &val8u, sizeof(val8u));
+			break;
+		case PlyType::UINT16:
+			memcpy(&val16u, ptr, sizeof(val16u));
+			val16u = (uint16_t)(val16u + offset);
+			memcpy(ptr, &val16u, sizeof(val16u));
+			break;
+		case PlyType::UINT32:
+			memcpy(&val32u, ptr, sizeof(val32u));
+			val32u = (uint32_t)(val32u + offset);
+			memcpy(ptr, &val32u, sizeof(val32u));
+			break;
+		case PlyType::UINT64:
+			memcpy(&val64u, ptr, sizeof(val64u));
+			val64u = val64u + (uint64_t)offset;
+			memcpy(ptr, &val64u, sizeof(val64u));
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+size_t formatValue(const char* src, const PlyType type, char* dst) {
+	int8_t val8i; int16_t val16i; int32_t val32i; int64_t val64i;
+	uint8_t val8u; uint16_t val16u; uint32_t val32u; uint64_t val64u;
+	float val32f; double val64f;
+	int length = 0;
+	switch (type) {
+	case PlyType::INT8:
+		memcpy(&val8i, src, sizeof(val8i));
+		length = snprintf(dst, 32, "%d", val8i);
+		break;
+	case PlyType::INT16:
+		memcpy(&val16i, src, sizeof(val16i));
+		length = snprintf(dst, 32, "%d", val16i);
+		break;
+	case PlyType::INT32:
+		memcpy(&val32i, src, sizeof(val32i));
+		length = snprintf(dst, 32, "%d", val32i);
+		break;
+	case PlyType::INT64:
+		memcpy(&val64i, src, sizeof(val64i));
+		length = snprintf(dst, 32, "%lld", (long long)val64i);
+		break;
+	case PlyType::UINT8:
+		memcpy(&val8u, src, sizeof(val8u));
+		length = snprintf(dst, 32, "%u", val8u);
+		break;
+	case PlyType::UINT16:
+		memcpy(&val16u, src, sizeof(val16u));
+		length = snprintf(dst, 32, "%u", val16u);
+		break;
+	case PlyType::UINT32:
+		memcpy(&val32u, src, sizeof(val32u));
+		length = snprintf(dst, 32, "%u", val32u);
+		break;
+	case PlyType::UINT64:
+		memcpy(&val64u, src, sizeof(val64u));
+		length = snprintf(dst, 32, "%llu", (unsigned long long)val64u);
+		break;
+	case PlyType::FLOAT32:
+		// precision guaranteeing exact round trips
+		memcpy(&val32f, src, sizeof(val32f));
+		length = snprintf(dst, 32, "%.9g", val32f);
+		break;
+	case PlyType::FLOAT64:
+		memcpy(&val64f, src, sizeof(val64f));
+		length = snprintf(dst, 32, "%.17g", val64f);
+		break;
+	default:
+		break;
+	}
+	return (size_t)length;
+}
+
+/*
+* Entry of the element cache.
+*/
+struct PlyCacheEntry {
+	// identification of file, element and selection
+	char* key = NULL;
+	// file holding the decoded element, its source is closed after decoding
+	PlyFile file;
+	// decoded element
+	const PlyElement* element = NULL;
+	// size of decoded data
+	size_t bytes = 0;
+	// number of users holding the element
+	size_t refCount = 0;
+	// true, while the element is decoded
+	bool loading = true;
+	// true, if decoding failed
+	bool failed = false;
+	// time of last use for eviction
+	uint64_t lastUse = 0;
+	// next entry
+	PlyCacheEntry* next = NULL;
+};
+
+/*
+* Process-wide element cache.
+*/
+struct PlyCache {
+	// guards all entries
+	std::mutex mutex;
+	// signals finished decodes
+	std::condition_variable loaded;
+	// list of entries
+	PlyCacheEntry* entries = NULL;
+	// size of decoded data of all entries
+	size_t bytes = 0;
+	// memory budget
+	size_t budget = 0;
+	// counter for least recently used order
+	uint64_t tick = 0;
+};
+
+static PlyCache plyCache;
+
+static void evictEntries(const size_t budget) {
+	// evict least recently used unreferenced entries, cache mutex must be held
+	while (plyCache.bytes > budget) {
+		PlyCacheEntry** victim = NULL;
+		for (PlyCacheEntry** entry = &plyCache.entries; *entry; entry = &(*entry)->next) {
+			if (!(*entry)->refCount && !(*entry)->loading && (!victim || (*entry)->lastUse < (*victim)->lastUse)) {
+				victim = entry;
+			}
+		}
+		if (!victim) {
+			break;
+		}
+		PlyCacheEntry* entry = *victim;
+		*victim = entry->next;
+		plyCache.bytes -= entry->bytes;
+		closePly(&entry->file);
+		free(entry->key);
+		free(entry);
+	}
+}
+
+const PlyElement* acquireElement(const char* path, const char* element, const size_t n, const char* const* properties, const PlyQuantization* quantizations) {
+	// identify file version by modification time and size
+	struct stat info;
+	if (stat(path, &info)) {
+		return NULL;
+	}
+	size_t keySize = strlen(path) + strlen(element) + 64;
+	for (size_t i = 0; i < n; ++i) {
+		keySize += strlen(properties[i]) + 8;
+	}
+	// use nanosecond timestamps where available, rewrites within a second are missed otherwise
+#if defined(_WIN32)
+	const long long modified = (long long)info.st_mtime * 1000000000LL;
+#elif defined(__APPLE__)
+	const long long modified = (long long)info.st_mtimespec.tv_sec * 1000000000LL + (long long)info.st_mtimespec.tv_nsec;
+#else
+	const long long modified = (long long)info.st_mtim.tv_sec * 1000000000LL + (long long)info.st_mtim.tv_nsec;
+#endif
+	char* key = (char*)malloc(keySize);
+	int length = snprintf(key, keySize, "%s|%lld|%lld|%s|", path, modified, (long long)info.st_size, element);
+	for (size_t i = 0; i < n; ++i) {
+		length += snprintf(key + length, keySize - length, "%s:%d,", properties[i], quantizations ? (int)quantizations[i] : 0);
+	}
+	// find entry or wait for concurrent decode of the same entry
+	PlyCacheEntry* entry;
+	{
+		std::unique_lock<std::mutex> lock(plyCache.mutex);
+		while (true) {
+			for (entry = plyCache.entries; entry && strcmp(entry->key, key); entry = entry->next) {
+			}
+			if (!entry || !entry->loading) {
+				break;
+			}
+			plyCache.loaded.wait(lock);
+		}
+		if (entry) {
+			free(key);
+			++entry->refCount;
+			entry->lastUse = ++plyCache.tick;
+			return entry->element;
+		}
+		// register entry so that concurrent requests wait for this decode
+		entry = (PlyCacheEntry*)malloc(sizeof(PlyCacheEntry));
+		*entry = PlyCacheEntry();
+		entry->key = key;
+		entry->refCount = 1;
+		entry->next = plyCache.entries;
+		plyCache.entries = entry;
+	}
+	// decode outside of lock
+	entry->file = openPly(path);
+	const int elemIdx = findElement(&entry->file, element);
+	bool success = (elemIdx != -1);
+	for (size_t i = 0; i < n && success && quantizations; ++i) {
+		if (quantizations[i] != QUANT_NONE) {
+			success = setQuantization(&entry->file, element, properties[i], quantizations[i]);
+		}
+	}
+	success = success && requestProperties(&entry->file, element, n, properties);
+	closeSource(&entry->file.source);
+	size_t bytes = 0;
+	const PlyElement* elem = success ? entry->file.elements + elemIdx : NULL;
+	for (size_t p = 0; elem && p < elem->propertyCount; ++p) {
+		const PlyProperty* prop = elem->properties + p;
+		bytes += prop->data ? (size_t)prop->propertySize : 0;
+		bytes += prop->listData ? elem->itemCount * PlyTypeSizes[prop->listType] : 0;
+	}
+	// publish entry and wake up waiting requests
+	std::lock_guard<std::mutex> lock(plyCache.mutex);
+	entry->loading = false;
+	if (!success) {
+		// drop failed entry, waiting requests retry on their own
+		for (PlyCacheEntry** it = &plyCache.entries; *it; it = &(*it)->next) {
+			if (*it == entry) {
+				*it = entry->next;
+				break;
+			}
+		}
+		closePly(&entry->file);
+		free(entry->key);
+		free(entry);
+		plyCache.loaded.notify_all();
+		return NULL;
+	}
+	entry->element = elem;
+	entry->bytes = bytes;
+	entry->lastUse = ++plyCache.tick;
+	plyCache.bytes += bytes;
+	evictEntries(plyCache.budget);
+	plyCache.loaded.notify_all();
+	return entry->element;
+}
+
+void releaseElement(const PlyElement* element) {
+	std::lock_guard<std::mutex> lock(plyCache.mutex);
+	for (PlyCacheEntry* entry = plyCache.entries; entry; entry = entry->next) {
+		// entries still loading have not published their element yet
+		if (!entry->loading && entry->element == element && entry->refCount) {
+			--entry->refCount;
+			break;
+		}
+	}
+	evictEntries(plyCache.budget);
+}
+
+void setCacheBudget(const size_t bytes) {
+	std::lock_guard<std::mutex> lock(plyCache.mutex);
+	plyCache.budget = bytes;
+	evictEntries(plyCache.budget);
+}
+
+void clearCache() {
+	std::lock_guard<std::mutex> lock(plyCache.mutex);
+	evictEntries(0);
+}
+
+int findElement(const PlyFile* file, const char* name) {
+	const size_t eCount = file->elementCount;
+	for (size_t e = 0; e < eCount; ++e) {
+		if (!strcmp(file->elements[e].name, name)) {
+			return (int)e;
+		}
+	}
+	return -1;
+}
+
+int findProperty(const PlyElement* elem, const char* name) {
+	const size_t pCount = elem->propertyCount;
+	for (size_t p = 0; p < pCount; ++p) {
+		if (!strcmp(elem->properties[p].name, name)) {
+			return (int)p;
+		}
+	}
+	return -1;
+}
+
+double getValue(const void* data, const PlyType type, const size_t idx) {
+	switch (type) {
+	case PlyType::INT8:
+		return ((const int8_t*)data)[idx];
+	case PlyType::INT16:
+		return ((const int16_t*)data)[idx];
+	case PlyType::INT32:
+		return ((const int32_t*)data)[idx];
+	case PlyType::INT64:
+		return (double)((const int64_t*)data)[idx];
+	case PlyType::UINT8:
+		return ((const uint8_t*)data)[idx];
+	case PlyType::UINT16:
+		return ((const uint16_t*)data)[idx];
+	case PlyType::UINT32:
+		return ((const uint32_t*)data)[idx];
+	case PlyType::UINT64:
+		return (double)((const uint64_t*)data)[idx];
+	case PlyType::FLOAT32:
+		return ((const float*)data)[idx];
+	case PlyType::FLOAT64:
+		return ((const double*)data)[idx];
+	default:
+		return 0.0;
+	}
+}
+
+bool setQuantization(PlyFile* file, const char* element, const char* property, const PlyQuantization mode) {
+	const int elemIdx = findElement(file, element);
+	if (elemIdx == -1 || mode == QUANT_OCT8) {
+		return false;
+	}
+	PlyElement* elem = file->elements + elemIdx;
+	const int propIdx = findProperty(elem, property);
+	if (propIdx == -1 || elem->properties[propIdx].listType != PlyType::NONE) {
+		return false;
+	}
+	PlyProperty* prop = elem->properties + propIdx;
+	prop->quantization = mode;
+	prop->quantLinks[0] = -1;
+	prop->quantLinks[1] = -1;
+	return true;
+}
+
+bool setNormalQuantization(PlyFile* file, const char* element, const char* nx, const char* ny, const char* nz) {
+	const int elemIdx = findElement(file, element);
+	if (elemIdx == -1) {
+		return false;
+	}
+	PlyElement* elem = file->elements + elemIdx;
+	const int idx[3] = { findProperty(elem, nx), findProperty(elem, ny), findProperty(elem, nz) };
+	for (int c = 0; c < 3; ++c) {
+		if (idx[c] == -1 || elem->properties[idx[c]].listType != PlyType::NONE) {
+			return false;
+		}
+	}
+	// the x component holds the encoded normals
+	for (int c = 0; c < 3; ++c) {
+		elem->properties[idx[c]].quantization = QUANT_OCT8;
+		elem->properties[idx[c]].quantLinks[0] = (c == 0) ? idx[1] : -1;
+		elem->properties[idx[c]].quantLinks[1] = (c == 0) ? idx[2] : -1;
+	}
+	return true;
+}
+
+/*
+* Arguments of quantization tasks.
+*/
+struct PlyQuantizeTask {
+	// property to be quantized
+	const PlyProperty* prop = NULL;
+	// y and z components of normals
+	const PlyProperty* links[2] = { NULL, NULL };
+	// number of values
+	size_t count = 0;
+	// target buffer
+	void* target = NULL;
+};
+
+static void quantizeRange(void* args, size_t thread, size_t threads) {
+	PlyQuantizeTask* task = (PlyQuantizeTask*)args;
+	const PlyProperty* prop = task->prop;
+	// align ranges to packed words
+	const size_t words = (task->count + 2) / 3;
+	size_t first = task->count * thread / threads;
+	size_t last = task->count * (thread + 1) / threads;
+	if (prop->quantization == QUANT_FIXED21) {
+		first = 3 * (words * thread / threads);
+		last = 3 * (words * (thread + 1) / threads);
+		last = (last < task->count) ? last : task->count;
+	}
+	const double invScale = prop->quantScale > 0.0 ? 1.0 / prop->quantScale : 0.0;
+	const double maxCode = (prop->quantization == QUANT_FIXED16) ? 65535.0 : 2097151.0;
+	double val, code;
+	uint16_t* target16 = (uint16_t*)task->target;
+	uint64_t* target64 = (uint64_t*)task->target;
+	uint8_t* target8 = (uint8_t*)task->target;
+	for (size_t i = first; i < last; ++i) {
+		if (prop->quantization == QUANT_OCT8) {
+			// project onto octahedron and unfold lower hemisphere
+			double x = getValue(prop->data, prop->type, i);
+			double y = getValue(task->links[0]->data, task->links[0]->type, i);
+			double z = getValue(task->links[1]->data, task->links[1]->type, i);
+			const double norm = fabs(x) + fabs(y) + fabs(z);
+			x = (norm > 0.0) ? x / norm : 0.0;
+			y = (norm > 0.0) ? y / norm : 0.0;
+			if (z < 0.0) {
+				const double xf = (1.0 - fabs(y)) * (x >= 0.0 ? 1.0 : -1.0);
+				y = (1.0 - fabs(x)) * (y >= 0.0 ? 1.0 : -1.0);
+				x = xf;
+			}
+			target8[2 * i] = (uint8_t)floor((x * 0.5 + 0.5) * 255.0 + 0.5);
+			target8[2 * i + 1] = (uint8_t)floor((y * 0.5 + 0.5) * 255.0 + 0.5);
+			continue;
+		}
+		// map value range to fixed point codes, NaNs map to zero
+		val = getValue(prop->data, prop->type, i);
+		code = floor((val - prop->quantOffset) * invScale + 0.5);
+		code = (code > 0.0) ? ((code < maxCode) ? code : maxCode) : 0.0;
+		if (prop->quantization == QUANT_FIXED16) {
+			target16[i] = (uint16_t)code;
+		}
+		else {
+			if (!(i % 3)) {
+				target64[i / 3] = 0;
+			}
+			target64[i / 3] |= (uint64_t)code << (21 * (i % 3));
+		}
+	}
+}
+
+void quantizeProperties(PlyFile* file, const size_t elemIdx) {
+	PlyElement elem = file->elements[elemIdx];
+	PlyProperty* props = elem.properties;
+	const size_t pCount = elem.propertyCount;
+	const size_t iCount = elem.itemCount;
+	const size_t threads = resolveThreadCount(file->threadCount, iCount);
+	PlyQuantizeTask task;
+	size_t targetSize;
+	for (size_t p = 0; p < pCount; ++p) {
+		PlyProperty* prop = props + p;
+		if (!prop->data || prop->quantization == QUANT_NONE || prop->dataQuantization != QUANT_NONE) {
+			continue;
+		}
+		task = PlyQuantizeTask();
+		task.prop = prop;
+		task.count = iCount;
+		switch (prop->quantization) {
+		case QUANT_FIXED16:
+		case QUANT_FIXED21:
+			// derive scale and offset from value range
+			prop->quantOffset = prop->statistics.count ? prop->statistics.min : 0.0;
+			prop->quantScale = prop->statistics.count ? (prop->statistics.max - prop->statistics.min) /
+				((prop->quantization == QUANT_FIXED16) ? 65535.0 : 2097151.0) : 0.0;
+			targetSize = (prop->quantization == QUANT_FIXED16) ? iCount * sizeof(uint16_t) : ((iCount + 2) / 3) * sizeof(uint64_t);
+			break;
+		case QUANT_OCT8:
+			// only x components with all components read are encoded
+			if (prop->quantLinks[0] == -1 || !props[prop->quantLinks[0]].data || !props[prop->quantLinks[1]].data) {
+				continue;
+			}
+			task.links[0] = props + prop->quantLinks[0];
+			task.links[1] = props + prop->quantLinks[1];
+			targetSize = 2 * iCount * sizeof(uint8_t);
+			break;
+		default:
+			continue;
+		}
+		task.target = malloc(targetSize);
+		runParallel(quantizeRange, &task, threads);
+		// replace raw data
+		free(prop->data);
+		prop->data = task.target;
+		prop->propertySize = (long)targetSize;
+		prop->dataQuantization = prop->quantization;
+		if (prop->quantization == QUANT_OCT8) {
+			for (int c = 0; c < 2; ++c) {
+				free(props[prop->quantLinks[c]].data);
+				props[prop->quantLinks[c]].data = NULL;
+				props[prop->quantLinks[c]].propertySize = 0;
+				props[prop->quantLinks[c]].dataQuantization = QUANT_OCT8;
+			}
+		}
+	}
+}
+
+double dequantizeValue(const PlyProperty* prop, const size_t idx) {
+	switch (prop->dataQuantization) {
+	case QUANT_FIXED16:
+		return prop->quantOffset + prop->quantScale * ((const uint16_t*)prop->data)[idx];
+	case QUANT_FIXED21:
+		return prop->quantOffset + prop->quantScale *
+			(double)((((const uint64_t*)prop->data)[idx / 3] >> (21 * (idx % 3))) & 0x1FFFFF);
+	case QUANT_OCT8: {
+		// encoded normals are held by the x component
+		float normal[3];
+		dequantizeNormal(prop, idx, normal);
+		return normal[0];
+	}
+	default:
+		return getValue(prop->data, prop->type, idx);
+	}
+}
+
+void dequantizeValues(const PlyProperty* prop, float* out, const size_t first, const size_t count) {
+	const float scale = (float)prop->quantScale;
+	const float offset = (float)prop->quantOffset;
+	const size_t last = first + count;
+	switch (prop->dataQuantization) {
+	case QUANT_FIXED16: {
+		const uint16_t* data16 = (const uint16_t*)prop->data;
+		for (size_t i = first; i < last; ++i) {
+			out[i - first] = offset + scale * (float)data16[i];
+		}
+		break;
+	}
+	case QUANT_FIXED21: {
+		const uint64_t* data64 = (const uint64_t*)prop->data;
+		for (size_t i = first; i < last; ++i) {
+			out[i - first] = offset + scale * (float)((data64[i / 3] >> (21 * (i % 3))) & 0x1FFFFF);
+		}
+		break;
+	}
+	case QUANT_OCT8: {
+		float normal[3];
+		for (size_t i = first; i < last; ++i) {
+			dequantizeNormal(prop, i, normal);
+			out[i - first] = normal[0];
+		}
+		break;
+	}
+	default:
+		if (prop->type == PlyType::FLOAT32) {
+			memcpy(out, (const float*)prop->data + first, count * sizeof(float));
+			break;
+		}
+		for (size_t i = first; i < last; ++i) {
+			out[i - first] = (float)getValue(prop->data, prop->type, i);
+		}
+		break;
+	}
+}
+
+void dequantizeNormal(const PlyProperty* prop, const size_t idx, float* normal) {
+	dequantizeNormals(prop, normal, idx, 1);
+}
+
+void dequantizeNormals(const PlyProperty* prop, float* out, const size_t first, const size_t count) {
+	const uint8_t* data8 = (const uint8_t*)prop->data;
+	float x, y, z, t, norm;
+	for (size_t i = 0; i < count; ++i) {
+		// fold back lower hemisphere
+		x = (float)data8[2 * (first + i)] * (2.0f / 255.0f) - 1.0f;
+		y = (float)data8[2 * (first + i) + 1] * (2.0f / 255.0f) - 1.0f;
+		z = 1.0f - fabsf(x) - fabsf(y);
+		t = (-z > 0.0f) ? -z : 0.0f;
+		x += (x >= 0.0f) ? -t : t;
+		y += (y >= 0.0f) ? -t : t;
+		norm = sqrtf(x * x + y * y + z * z);
+		norm = (norm > 0.0f) ? 1.0f / norm : 0.0f;
+		out[3 * i] = x * norm;
+		out[3 * i + 1] = y * norm;
+		out[3 * i + 2] = z * norm;
+	}
+}
+
+bool readPropertiesAscii(PlyFile* file, const size_t elemIdx) {
+	// setup properties and jump to element block
+	PlyElement elem = file->elements[elemIdx];
+	PlyProperty* props = elem.properties;
+	const size_t iCount = elem.fileItemCount;
+	const size_t pCount = elem.propertyCount;
+	if (!sourceSeek(&file->source, elem.dataStart)) {
+		return false;
+	}
+	// fixed-size items are parsed in parallel from staged lines
+	bool fixedLength = true;
+	for (size_t p = 0; p < pCount; ++p) {
+		fixedLength &= (props[p].listType == PlyType::NONE);
+	}
+	if (fixedLength) {
+		return readFixedPropertiesAscii(file, elemIdx);
+	}
+	// allocate buffer for reading
+	char buffer[MUPLY_BUFFER_SIZE];
+	// keep allocated sizes and setup position indices for the requested properties
+	long* capacities = (long*)malloc(pCount * sizeof(long));
+	for (size_t p = 0; p < pCount; ++p) {
+		capacities[p] = props[p].propertySize;
+		if (props[p].data) {
+			props[p].propertySize = 0;
+			props[p].statistics = PlyStatistics();
+		}
+	}
+	const bool computeStatistics = requiresStatistics(file, elemIdx);
+	// setup properties
+	char* token;
+	size_t itemSize;
+	int listElements, pIdx;
+	int8_t* data;
 	uint8_t* data8u; uint16_t* data16u; uint32_t* data32u; uint64_t* data64u;
 	int8_t* data8i; int16_t* data16i; int32_t* data32i; int64_t* data64i;
 	float* data32f; double* data64f;
@@ -520,9 +2375,9 @@ void readPropertiesAscii(PlyFile* file, const size_t elemIdx) {
 	// read data
 	for (size_t i = 0; i < iCount; ++i) {
 		// get line and split tokens
-		fgets(buffer, MUPLY_BUFFER_SIZE, file->file);
+		sourceGets(&file->source, buffer, MUPLY_BUFFER_SIZE);
 		token = strtok(buffer, MUPLY_TOKEN_SEP);
-		for (size_t p = 0; p < pCount; ++p) {
+		for (size_t p = 0; p < pCount && token; ++p) {
 			prop = props[p];
 			if (prop.data) {
 				listElements = 1;
@@ -534,6 +2389,13 @@ void readPropertiesAscii(PlyFile* file, const size_t elemIdx) {
 					data = (int8_t*)prop.listData;
 					memcpy(data + i * itemSize, &listElements, itemSize);
 					token = strtok(NULL, MUPLY_TOKEN_SEP);
+					// grow property buffer if list sizes were underestimated
+					itemSize = PlyTypeSizes[prop.type];
+					if ((long)((pIdx + listElements) * itemSize) > capacities[p]) {
+						capacities[p] = 2 * capacities[p] + (long)(listElements * itemSize);
+						prop.data = realloc(prop.data, capacities[p]);
+						props[p].data = prop.data;
+					}
 				}
 				// switch over data type to convert token appropriately
 				switch (prop.type) {
@@ -610,68 +2472,1534 @@ void readPropertiesAscii(PlyFile* file, const size_t elemIdx) {
 				default:
 					break;
 				}
-				props[p].propertySize += (long)listElements;
-			}			
+				// accumulate statistics of converted values
+				if (computeStatistics) {
+					accumulateStatistics((int8_t*)prop.data + prop.propertySize * PlyTypeSizes[prop.type], prop.type, listElements, &props[p].statistics);
+				}
+				props[p].propertySize += (long)listElements;
+			}
+			else if (prop.listType != PlyType::NONE) {
+				// skip list entries of unrequested property
+				listElements = atoi(token);
+				for (int l = 0; l < listElements; ++l) {
+					strtok(NULL, MUPLY_TOKEN_SEP);
+				}
+				token = strtok(NULL, MUPLY_TOKEN_SEP);
+			}
+			else {
+				token = strtok(NULL, MUPLY_TOKEN_SEP);
+			}
+		}
+	}
+	// restore property sizes after abusing them
+	for (size_t p = 0; p < pCount; ++p) {
+		prop = props[p];
+		if (prop.data) {
+			props[p].propertySize *= (long)PlyTypeSizes[prop.type];
+		}
+	}
+	free(capacities);
+	// start of next element is known now
+	if (elemIdx + 1 < (size_t)file->elementCount) {
+		file->elements[elemIdx + 1].dataStart = sourceTell(&file->source);
+	}
+	return true;
+}
+
+/*
+* Arguments of ascii parsing tasks.
+*/
+struct PlyAsciiTask {
+	// properties of element
+	PlyProperty* props = NULL;
+	// number of properties
+	size_t pCount = 0;
+	// staged chunk of complete lines
+	const char* lines = NULL;
+	// size of staged chunk
+	size_t size = 0;
+	// byte offsets of thread slices within chunk, threads + 1 entries
+	size_t* sliceStarts = NULL;
+	// item offsets of thread slices within chunk, threads + 1 entries
+	size_t* sliceItems = NULL;
+	// index of first staged item within element
+	size_t firstItem = 0;
+	// per-thread statistics of each property, NULL if not requested
+	PlyStatistics* statistics = NULL;
+};
+
+static void countAsciiSlice(void* args, size_t thread, size_t threads) {
+	// count lines of slice, a final line may lack its line break
+	PlyAsciiTask* task = (PlyAsciiTask*)args;
+	const size_t start = task->sliceStarts[thread];
+	const size_t size = task->sliceStarts[thread + 1] - start;
+	size_t lines = countLines(task->lines + start, size);
+	if (thread + 1 == threads && size && task->lines[task->size - 1] != '\n') {
+		++lines;
+	}
+	task->sliceItems[thread + 1] = lines;
+}
+
+static void parseAsciiSlice(void* args, size_t thread, size_t threads) {
+	// convert tokens of each line of slice
+	PlyAsciiTask* task = (PlyAsciiTask*)args;
+	PlyProperty* props = task->props;
+	const size_t pCount = task->pCount;
+	const char* pos = task->lines + task->sliceStarts[thread];
+	const char* end = task->lines + task->sliceStarts[thread + 1];
+	const size_t first = task->firstItem + task->sliceItems[thread];
+	const size_t count = task->sliceItems[thread + 1] - task->sliceItems[thread];
+	char token[MUPLY_TOKEN_SIZE];
+	const char* tokenEnd;
+	size_t skipped, size;
+	for (size_t i = first; i < first + count; ++i) {
+		for (size_t p = 0; p < pCount; ++p) {
+			pos = skipSpaces(pos, end);
+			tokenEnd = skipToken(pos, end);
+			if (props[p].data) {
+				size = PlyTypeSizes[props[p].type];
+				parseValue(copyToken(pos, tokenEnd, token), props[p].type, (char*)props[p].data + i * size);
+			}
+			pos = tokenEnd;
+		}
+		// skip remainder of line
+		skipped = 1;
+		pos = findLines(pos, end - pos, &skipped);
+	}
+	// accumulate statistics of slice output
+	if (task->statistics) {
+		for (size_t p = 0; p < pCount; ++p) {
+			if (props[p].data) {
+				size = PlyTypeSizes[props[p].type];
+				accumulateStatistics((char*)props[p].data + first * size, props[p].type, count, task->statistics + thread * pCount + p);
+			}
+		}
+	}
+	(void)threads;
+}
+
+bool readFixedPropertiesAscii(PlyFile* file, const size_t elemIdx) {
+	PlyElement elem = file->elements[elemIdx];
+	PlyProperty* props = elem.properties;
+	const size_t pCount = elem.propertyCount;
+	const size_t iCount = elem.fileItemCount;
+	PlySource* source = &file->source;
+	// task setup
+	const size_t maxThreads = resolveThreadCount(file->threadCount);
+	PlyAsciiTask task;
+	task.props = props;
+	task.pCount = pCount;
+	task.sliceStarts = (size_t*)malloc((maxThreads + 1) * sizeof(size_t));
+	task.sliceItems = (size_t*)malloc((maxThreads + 1) * sizeof(size_t));
+	if (requiresStatistics(file, elemIdx)) {
+		task.statistics = (PlyStatistics*)malloc(maxThreads * pCount * sizeof(PlyStatistics));
+		for (size_t s = 0; s < maxThreads * pCount; ++s) {
+			task.statistics[s] = PlyStatistics();
+		}
+	}
+	// stage chunks of complete lines and split them at line boundaries
+	size_t chunkSize = maxThreads * MUPLY_CHUNK_SIZE;
+	size_t lines, used, threads, target, skipped;
+	const char* next;
+	while (task.firstItem < iCount && (lines = stageLines(source, iCount - task.firstItem, &chunkSize, &used))) {
+		task.lines = source->buffer + source->bufferPos;
+		task.size = used;
+		threads = resolveThreadCount(file->threadCount, lines);
+		task.sliceStarts[0] = 0;
+		for (size_t t = 1; t < threads; ++t) {
+			target = used * t / threads;
+			skipped = 1;
+			next = findLines(task.lines + target, used - target, &skipped);
+			target = skipped ? (size_t)(next - task.lines) : used;
+			task.sliceStarts[t] = (target > task.sliceStarts[t - 1]) ? target : task.sliceStarts[t - 1];
+		}
+		task.sliceStarts[threads] = used;
+		// count lines of each slice to get the items of each thread
+		task.sliceItems[0] = 0;
+		runParallel(countAsciiSlice, &task, threads);
+		for (size_t t = 0; t < threads; ++t) {
+			task.sliceItems[t + 1] += task.sliceItems[t];
+		}
+		runParallel(parseAsciiSlice, &task, threads);
+		source->bufferPos += used;
+		task.firstItem += lines;
+	}
+	// set final property sizes and merge statistics of threads
+	for (size_t p = 0; p < pCount; ++p) {
+		if (props[p].data) {
+			props[p].propertySize = (long)(task.firstItem * PlyTypeSizes[props[p].type]);
+			props[p].statistics = PlyStatistics();
+			if (task.statistics) {
+				for (size_t t = 0; t < maxThreads; ++t) {
+					mergeStatistics(&props[p].statistics, task.statistics + t * pCount + p);
+				}
+			}
+		}
+	}
+	free(task.statistics);
+	free(task.sliceStarts);
+	free(task.sliceItems);
+	// start of next element is known now
+	if (elemIdx + 1 < (size_t)file->elementCount) {
+		file->elements[elemIdx + 1].dataStart = sourceTell(source);
+	}
+	return task.firstItem == iCount;
+}
+
+/*
+* Arguments of curve code tasks.
+*/
+struct PlyCodeTask {
+	// coordinate properties
+	const PlyProperty* coords[3] = { NULL, NULL, NULL };
+	// minimum of each coordinate
+	double mins[3] = { 0.0, 0.0, 0.0 };
+	// scale of each coordinate to 21bit
+	double scales[3] = { 0.0, 0.0, 0.0 };
+	// curve type
+	PlyCurve curve = CURVE_MORTON;
+	// target codes
+	uint64_t* keys = NULL;
+	// target item indices
+	uint32_t* values = NULL;
+	// number of items
+	size_t count = 0;
+};
+
+static void computeCurveCodes(void* args, size_t thread, size_t threads) {
+	PlyCodeTask* task = (PlyCodeTask*)args;
+	const size_t first = task->count * thread / threads;
+	const size_t last = task->count * (thread + 1) / threads;
+	uint32_t grid[3];
+	double val;
+	for (size_t i = first; i < last; ++i) {
+		// map coordinates to 21bit grid, NaNs map to zero
+		for (int c = 0; c < 3; ++c) {
+			val = (dequantizeValue(task->coords[c], i) - task->mins[c]) * task->scales[c];
+			val = (val > 0.0) ? ((val < 2097151.0) ? val : 2097151.0) : 0.0;
+			grid[c] = (uint32_t)val;
+		}
+		task->keys[i] = (task->curve == CURVE_HILBERT) ? hilbertCode(grid[0], grid[1], grid[2]) : mortonCode(grid[0], grid[1], grid[2]);
+		task->values[i] = (uint32_t)i;
+	}
+}
+
+/*
+* Arguments of radix sort tasks.
+*/
+struct PlySortTask {
+	// keys of current source and target
+	uint64_t* keys[2] = { NULL, NULL };
+	// values of current source and target
+	uint32_t* values[2] = { NULL, NULL };
+	// number of keys
+	size_t count = 0;
+	// per-thread digit histograms, turned into scatter offsets
+	size_t* counts = NULL;
+	// shift of current digit
+	int shift = 0;
+};
+
+static void radixHistogram(void* args, size_t thread, size_t threads) {
+	PlySortTask* task = (PlySortTask*)args;
+	const size_t first = task->count * thread / threads;
+	const size_t last = task->count * (thread + 1) / threads;
+	size_t* counts = task->counts + thread * 256;
+	const uint64_t* keys = task->keys[0];
+	for (size_t i = first; i < last; ++i) {
+		++counts[(keys[i] >> task->shift) & 0xFF];
+	}
+}
+
+static void radixScatter(void* args, size_t thread, size_t threads) {
+	PlySortTask* task = (PlySortTask*)args;
+	const size_t first = task->count * thread / threads;
+	const size_t last = task->count * (thread + 1) / threads;
+	size_t* offsets = task->counts + thread * 256;
+	const uint64_t* keys = task->keys[0];
+	const uint32_t* values = task->values[0];
+	size_t digit, target;
+	for (size_t i = first; i < last; ++i) {
+		digit = (keys[i] >> task->shift) & 0xFF;
+		target = offsets[digit]++;
+		task->keys[1][target] = keys[i];
+		task->values[1][target] = values[i];
+	}
+}
+
+/*
+* Arguments of permutation tasks.
+*/
+struct PlyGatherTask {
+	// source data
+	const char* src = NULL;
+	// target data
+	char* dst = NULL;
+	// bytes per item, 0 for packed 21bit values
+	size_t size = 0;
+	// old indices in new order
+	const uint32_t* order = NULL;
+	// number of items
+	size_t count = 0;
+};
+
+static void gatherItems(void* args, size_t thread, size_t threads) {
+	PlyGatherTask* task = (PlyGatherTask*)args;
+	const uint32_t* order = task->order;
+	size_t first = task->count * thread / threads;
+	size_t last = task->count * (thread + 1) / threads;
+	switch (task->size) {
+	case 0: {
+		// align ranges to packed words
+		const size_t words = (task->count + 2) / 3;
+		const uint64_t* src64 = (const uint64_t*)task->src;
+		uint64_t* dst64 = (uint64_t*)task->dst;
+		first = 3 * (words * thread / threads);
+		last = 3 * (words * (thread + 1) / threads);
+		last = (last < task->count) ? last : task->count;
+		for (size_t i = first; i < last; ++i) {
+			if (!(i % 3)) {
+				dst64[i / 3] = 0;
+			}
+			dst64[i / 3] |= ((src64[order[i] / 3] >> (21 * (order[i] % 3))) & 0x1FFFFF) << (21 * (i % 3));
+		}
+		break;
+	}
+	case 1:
+		for (size_t i = first; i < last; ++i) {
+			task->dst[i] = task->src[order[i]];
+		}
+		break;
+	case 2:
+		for (size_t i = first; i < last; ++i) {
+			((uint16_t*)task->dst)[i] = ((const uint16_t*)task->src)[order[i]];
+		}
+		break;
+	case 4:
+		for (size_t i = first; i < last; ++i) {
+			((uint32_t*)task->dst)[i] = ((const uint32_t*)task->src)[order[i]];
+		}
+		break;
+	case 8:
+		for (size_t i = first; i < last; ++i) {
+			((uint64_t*)task->dst)[i] = ((const uint64_t*)task->src)[order[i]];
+		}
+		break;
+	default:
+		for (size_t i = first; i < last; ++i) {
+			memcpy(task->dst + i * task->size, task->src + order[i] * task->size, task->size);
+		}
+		break;
+	}
+}
+
+/*
+* Arguments of index remapping tasks.
+*/
+struct PlyRemapTask {
+	// index values
+	void* data = NULL;
+	// type of index values
+	PlyType type = PlyType::INT32;
+	// number of index values
+	size_t count = 0;
+	// lookup table from old to new indices
+	const uint32_t* map = NULL;
+	// size of lookup table
+	size_t mapCount = 0;
+};
+
+static void remapRange(void* args, size_t thread, size_t threads) {
+	PlyRemapTask* task = (PlyRemapTask*)args;
+	const size_t first = task->count * thread / threads;
+	const size_t last = task->count * (thread + 1) / threads;
+	const uint32_t* map = task->map;
+	const uint64_t mapCount = task->mapCount;
+	uint64_t idx;
+	switch (task->type) {
+	case PlyType::INT8:
+	case PlyType::UINT8:
+		for (size_t i = first; i < last; ++i) {
+			idx = ((uint8_t*)task->data)[i];
+			((uint8_t*)task->data)[i] = (idx < mapCount) ? (uint8_t)map[idx] : (uint8_t)idx;
+		}
+		break;
+	case PlyType::INT16:
+	case PlyType::UINT16:
+		for (size_t i = first; i < last; ++i) {
+			idx = ((uint16_t*)task->data)[i];
+			((uint16_t*)task->data)[i] = (idx < mapCount) ? (uint16_t)map[idx] : (uint16_t)idx;
+		}
+		break;
+	case PlyType::INT32:
+	case PlyType::UINT32:
+		for (size_t i = first; i < last; ++i) {
+			idx = ((uint32_t*)task->data)[i];
+			((uint32_t*)task->data)[i] = (idx < mapCount) ? map[idx] : (uint32_t)idx;
+		}
+		break;
+	case PlyType::INT64:
+	case PlyType::UINT64:
+		for (size_t i = first; i < last; ++i) {
+			idx = ((uint64_t*)task->data)[i];
+			((uint64_t*)task->data)[i] = (idx < mapCount) ? map[idx] : idx;
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+/*
+* Arguments of binary decoding tasks.
+*/
+struct PlyBinaryTask {
+	// source for positioned reads
+	PlySource* source = NULL;
+	// properties of element
+	PlyProperty* props = NULL;
+	// number of properties
+	size_t pCount = 0;
+	// offsets of properties within fixed-size items
+	size_t* offsets = NULL;
+	// size of fixed-size items
+	size_t stride = 0;
+	// true, if values need to be byteswapped
+	bool swap = false;
+	// start of element block in source
+	long dataStart = 0;
+	// number of items in element or chunk
+	size_t itemCount = 0;
+	// staged chunk of items
+	const char* items = NULL;
+	// index of first staged item within element
+	size_t firstItem = 0;
+	// byte offsets of index blocks within staged chunk
+	size_t* blockOffsets = NULL;
+	// output positions of each property at the start of each index block
+	size_t* blockStarts = NULL;
+	// number of index blocks
+	size_t blockCount = 0;
+	// per-thread statistics of each property, NULL if not requested
+	PlyStatistics* statistics = NULL;
+	// set if a positioned read failed
+	std::atomic<bool> failed;
+	// byte ranges within items read by sparse positioned reads
+	size_t* segmentStarts = NULL;
+	size_t* segmentSizes = NULL;
+	size_t segmentCount = 0;
+	// size of items packed from byte ranges
+	size_t packedStride = 0;
+	// offsets of requested properties within packed items
+	size_t* packedOffsets = NULL;
+	// offset of byte ranges within items, ranges behind the largest gap belong to the following item
+	size_t phase = 0;
+};
+
+static bool planSparseRead(PlyBinaryTask* task) {
+	const PlyProperty* props = task->props;
+	const size_t pCount = task->pCount;
+	const size_t stride = task->stride;
+	const size_t requestCost = (task->source->kind == PlySourceKind::SOURCE_NETWORK) ? MUPLY_NETWORK_REQUEST_COST : MUPLY_LOCAL_REQUEST_COST;
+	task->segmentStarts = (size_t*)malloc((pCount + 1) * sizeof(size_t));
+	task->segmentSizes = (size_t*)malloc((pCount + 1) * sizeof(size_t));
+	task->packedOffsets = (size_t*)malloc((pCount + 1) * sizeof(size_t));
+	task->segmentCount = 0;
+	task->packedStride = 0;
+	task->phase = 0;
+	// find largest gap between requested properties, including the gap to the next item
+	size_t first = pCount, origin = pCount, gap = 0, end = 0;
+	for (size_t p = 0; p < pCount; ++p) {
+		if (!props[p].data) {
+			continue;
+		}
+		if (first == pCount) {
+			first = p;
+		}
+		else if (task->offsets[p] - end > gap) {
+			gap = task->offsets[p] - end;
+			origin = p;
+		}
+		end = task->offsets[p] + PlyTypeSizes[props[p].type];
+	}
+	if (first == pCount) {
+		return false;
+	}
+	if (stride - end + task->offsets[first] >= gap) {
+		gap = stride - end + task->offsets[first];
+		origin = first;
+	}
+	// ranges only need to be shifted if the largest gap lies within items
+	task->phase = (origin != first) ? task->offsets[origin] : 0;
+	// skipping pays off only for gaps larger than a request, all others are read along
+	if (gap < requestCost) {
+		return false;
+	}
+	// merge byte ranges of requested properties starting behind the largest gap, so runs may cross item boundaries
+	size_t start, size, lastEnd = 0;
+	for (size_t k = 0; k < pCount; ++k) {
+		const size_t p = (origin + k) % pCount;
+		if (!props[p].data) {
+			continue;
+		}
+		start = (task->offsets[p] + stride - task->phase) % stride;
+		size = PlyTypeSizes[props[p].type];
+		if (task->segmentCount) {
+			lastEnd = task->segmentStarts[task->segmentCount - 1] + task->segmentSizes[task->segmentCount - 1];
+		}
+		if (task->segmentCount && start - lastEnd < requestCost) {
+			task->segmentSizes[task->segmentCount - 1] = start + size - task->segmentStarts[task->segmentCount - 1];
+		}
+		else {
+			task->segmentStarts[task->segmentCount] = start;
+			task->segmentSizes[task->segmentCount++] = size;
+		}
+	}
+	for (size_t s = 0; s < task->segmentCount; ++s) {
+		task->packedStride += task->segmentSizes[s];
+	}
+	// compare costs of a sequential block read and the sparse read
+	const double items = (double)task->itemCount;
+	const double fullBytes = items * (double)stride;
+	const double fullCost = fullBytes + ceil(fullBytes / MUPLY_CHUNK_SIZE) * (double)requestCost;
+	const double sparseCost = items * ((double)task->packedStride + (double)task->segmentCount * (double)requestCost);
+	if (sparseCost >= fullCost) {
+		return false;
+	}
+	// get offsets of requested properties within packed items, which start with the preceding packed item if runs cross items
+	for (size_t p = 0; p < pCount; ++p) {
+		if (!props[p].data) {
+			continue;
+		}
+		start = (task->offsets[p] + stride - task->phase) % stride;
+		size_t packed = 0;
+		size_t s = 0;
+		while (start >= task->segmentStarts[s] + task->segmentSizes[s]) {
+			packed += task->segmentSizes[s++];
+		}
+		task->packedOffsets[p] = packed + start - task->segmentStarts[s];
+		if (task->phase && task->offsets[p] >= task->phase) {
+			task->packedOffsets[p] += task->packedStride;
+		}
+	}
+	return true;
+}
+
+static void decodeFixedItems(PlyBinaryTask* task, const char* items, const size_t stride, const size_t* offsets, const size_t firstItem, const size_t count, const size_t thread) {
+	// deinterleave each requested property into its target array
+	PlyProperty* props = task->props;
+	size_t size;
+	char* dst;
+	for (size_t p = 0; p < task->pCount; ++p) {
+		if (props[p].data) {
+			size = PlyTypeSizes[props[p].type];
+			dst = (char*)props[p].data + firstItem * size;
+			decodeValues(items + offsets[p], stride, count, dst, size, task->swap);
+			// values are still cached
+			if (task->statistics) {
+				accumulateStatistics(dst, props[p].type, count, task->statistics + thread * task->pCount + p);
+			}
+		}
+	}
+}
+
+static void decodeFixedPositioned(void* args, size_t thread, size_t threads) {
+	// decode contiguous range of items with positioned reads
+	PlyBinaryTask* task = (PlyBinaryTask*)args;
+	PlySource* source = task->source;
+	const size_t stride = task->stride;
+	const size_t first = task->itemCount * thread / threads;
+	const size_t last = task->itemCount * (thread + 1) / threads;
+	const size_t chunkItems = (MUPLY_CHUNK_SIZE > stride) ? MUPLY_CHUNK_SIZE / stride : 1;
+	// in-memory sources are decoded without staging
+	char* staging = source->read ? (char*)malloc(chunkItems * stride) : NULL;
+	const char* items;
+	size_t count, bytes;
+	long offset;
+	for (size_t i = first; i < last; i += count) {
+		count = (last - i < chunkItems) ? last - i : chunkItems;
+		bytes = count * stride;
+		offset = task->dataStart + (long)(i * stride);
+		if (staging) {
+			if (source->readAt(source->handle, staging, bytes, offset) != bytes) {
+				task->failed = true;
+				break;
+			}
+			items = staging;
+		}
+		else {
+			if ((size_t)offset + bytes > source->bufferFill) {
+				task->failed = true;
+				break;
+			}
+			items = source->buffer + offset;
+		}
+		decodeFixedItems(task, items, stride, task->offsets, i, count, thread);
+	}
+	free(staging);
+}
+
+static void decodeFixedSparse(void* args, size_t thread, size_t threads) {
+	// decode contiguous range of items reading only the planned byte ranges of each item
+	PlyBinaryTask* task = (PlyBinaryTask*)args;
+	PlySource* source = task->source;
+	const size_t packedStride = task->packedStride;
+	const size_t first = task->itemCount * thread / threads;
+	const size_t last = task->itemCount * (thread + 1) / threads;
+	const size_t chunkItems = (MUPLY_CHUNK_SIZE > packedStride) ? MUPLY_CHUNK_SIZE / packedStride : 1;
+	// ranges shifted behind the largest gap hold the leading properties of the following item
+	const size_t leading = task->phase ? 1 : 0;
+	const long blockEnd = task->dataStart + (long)(task->itemCount * task->stride);
+	char* staging = (char*)malloc((chunkItems + leading) * packedStride);
+	char* dst;
+	size_t count;
+	long offset, rangeStart, rangeEnd;
+	for (size_t i = first; i < last && !task->failed; i += count) {
+		count = (last - i < chunkItems) ? last - i : chunkItems;
+		for (size_t c = 0; c < count + leading && !task->failed; ++c) {
+			dst = staging + c * packedStride;
+			offset = task->dataStart + ((long)(i + c) - (long)leading) * (long)task->stride + (long)task->phase;
+			for (size_t s = 0; s < task->segmentCount; ++s) {
+				// clip ranges to element block
+				rangeStart = offset + (long)task->segmentStarts[s];
+				rangeEnd = rangeStart + (long)task->segmentSizes[s];
+				rangeStart = (rangeStart > task->dataStart) ? rangeStart : task->dataStart;
+				rangeEnd = (rangeEnd < blockEnd) ? rangeEnd : blockEnd;
+				if (rangeStart < rangeEnd && source->readAt(source->handle, dst + (rangeStart - offset - (long)task->segmentStarts[s]),
+					(size_t)(rangeEnd - rangeStart), rangeStart) != (size_t)(rangeEnd - rangeStart)) {
+					task->failed = true;
+					break;
+				}
+				dst += task->segmentSizes[s];
+			}
+		}
+		if (!task->failed) {
+			decodeFixedItems(task, staging, packedStride, task->packedOffsets, i, count, thread);
+		}
+	}
+	free(staging);
+}
+
+static void decodeFixedStaged(void* args, size_t thread, size_t threads) {
+	// decode slice of staged chunk
+	PlyBinaryTask* task = (PlyBinaryTask*)args;
+	const size_t first = task->itemCount * thread / threads;
+	const size_t last = task->itemCount * (thread + 1) / threads;
+	decodeFixedItems(task, task->items + first * task->stride, task->stride, task->offsets, task->firstItem + first, last - first, thread);
+}
+
+static void decodeListStaged(void* args, size_t thread, size_t threads) {
+	// decode index blocks of staged chunk
+	PlyBinaryTask* task = (PlyBinaryTask*)args;
+	PlyProperty* props = task->props;
+	const size_t pCount = task->pCount;
+	const bool swap = task->swap;
+	const size_t firstBlock = task->blockCount * thread / threads;
+	const size_t lastBlock = task->blockCount * (thread + 1) / threads;
+	size_t listTypeSize, itemSize, lastItem, outIdx;
+	int64_t listElements;
+	const char* pos;
+	PlyProperty prop;
+	size_t* blockEnds = (size_t*)malloc(pCount * sizeof(size_t));
+	for (size_t b = firstBlock; b < lastBlock; ++b) {
+		// keep output positions of block for statistics
+		if (task->statistics) {
+			memcpy(blockEnds, task->blockStarts + b * pCount, pCount * sizeof(size_t));
+		}
+		pos = task->items + task->blockOffsets[b];
+		lastItem = (b + 1) * MUPLY_INDEX_BLOCK;
+		lastItem = (lastItem < task->itemCount) ? lastItem : task->itemCount;
+		for (size_t i = b * MUPLY_INDEX_BLOCK; i < lastItem; ++i) {
+			for (size_t p = 0; p < pCount; ++p) {
+				prop = props[p];
+				listElements = 1;
+				if (prop.listType != PlyType::NONE) {
+					listTypeSize = PlyTypeSizes[prop.listType];
+					listElements = readListLength(pos, prop.listType, swap);
+					if (prop.data) {
+						decodeValues(pos, listTypeSize, 1, (char*)prop.listData + (task->firstItem + i) * listTypeSize, listTypeSize, swap);
+					}
+					pos += listTypeSize;
+				}
+				itemSize = PlyTypeSizes[prop.type];
+				if (prop.data) {
+					outIdx = task->blockStarts[b * pCount + p];
+					decodeValues(pos, itemSize, (size_t)listElements, (char*)prop.data + outIdx * itemSize, itemSize, swap);
+					task->blockStarts[b * pCount + p] = outIdx + (size_t)listElements;
+				}
+				pos += (size_t)listElements * itemSize;
+			}
+		}
+		// accumulate statistics of cached block output
+		if (task->statistics) {
+			for (size_t p = 0; p < pCount; ++p) {
+				if (props[p].data) {
+					itemSize = PlyTypeSizes[props[p].type];
+					accumulateStatistics((char*)props[p].data + blockEnds[p] * itemSize, props[p].type,
+						task->blockStarts[b * pCount + p] - blockEnds[p], task->statistics + thread * pCount + p);
+				}
+			}
+		}
+	}
+	free(blockEnds);
+}
+
+bool readPropertiesBinary(PlyFile* file, const size_t elemIdx) {
+	// setup properties and jump to element block
+	PlyElement elem = file->elements[elemIdx];
+	PlyProperty* props = elem.properties;
+	const size_t iCount = elem.fileItemCount;
+	const size_t pCount = elem.propertyCount;
+	PlySource* source = &file->source;
+	if (!sourceSeek(source, elem.dataStart)) {
+		return false;
+	}
+	// task setup
+	PlyBinaryTask task;
+	task.source = source;
+	task.props = props;
+	task.pCount = pCount;
+	task.swap = requiresByteSwap(file);
+	task.dataStart = elem.dataStart;
+	task.failed = false;
+	const size_t maxThreads = resolveThreadCount(file->threadCount);
+	size_t threads;
+	if (requiresStatistics(file, elemIdx)) {
+		task.statistics = (PlyStatistics*)malloc(maxThreads * pCount * sizeof(PlyStatistics));
+		for (size_t s = 0; s < maxThreads * pCount; ++s) {
+			task.statistics[s] = PlyStatistics();
+		}
+	}
+	// get property offsets within items and check for variable length properties
+	bool fixedLength = true;
+	task.offsets = (size_t*)malloc(pCount * sizeof(size_t));
+	for (size_t p = 0; p < pCount; ++p) {
+		task.offsets[p] = task.stride;
+		task.stride += PlyTypeSizes[props[p].type];
+		fixedLength &= (props[p].listType == PlyType::NONE);
+	}
+	// keep allocated sizes and setup output positions for the requested properties
+	long* capacities = (long*)malloc(pCount * sizeof(long));
+	size_t* cursors = (size_t*)calloc(pCount, sizeof(size_t));
+	for (size_t p = 0; p < pCount; ++p) {
+		capacities[p] = props[p].propertySize;
+	}
+	bool success = true;
+	if (fixedLength && !task.stride) {
+		// nothing to decode for items without data
+	}
+	else if (fixedLength && sourceSeekable(source) && (source->readAt || !source->read)) {
+		// split item range across threads reading with their own positioned reads
+		// wide items with few requested properties are read sparsely if that saves enough bytes
+		task.itemCount = iCount;
+		if (source->read && planSparseRead(&task)) {
+			runParallel(decodeFixedSparse, &task, resolveThreadCount(file->threadCount, iCount));
+		}
+		else {
+			runParallel(decodeFixedPositioned, &task, resolveThreadCount(file->threadCount, iCount));
+		}
+		success = !task.failed && sourceSeek(source, elem.dataStart + (long)(iCount * task.stride));
+		for (size_t p = 0; p < pCount; ++p) {
+			cursors[p] = iCount;
+		}
+	}
+	else {
+		// stage chunks of complete items in the source buffer and split them across threads
+		const size_t indexCapacity = (maxThreads * MUPLY_CHUNK_SIZE) / MUPLY_INDEX_BLOCK + 1;
+		size_t chunkSize = maxThreads * MUPLY_CHUNK_SIZE;
+		size_t item = 0;
+		size_t available, used, count, listTypeSize, itemSize;
+		int64_t listElements;
+		const char* items;
+		size_t* lengths = (size_t*)malloc(pCount * sizeof(size_t));
+		if (!fixedLength) {
+			task.blockOffsets = (size_t*)malloc(indexCapacity * sizeof(size_t));
+			task.blockStarts = (size_t*)malloc(indexCapacity * pCount * sizeof(size_t));
+		}
+		while (item < iCount) {
+			if (fixedLength) {
+				// stage fixed-size items without reading beyond the element block
+				available = (iCount - item) * task.stride;
+				available = sourceEnsure(source, (available < chunkSize) ? available : chunkSize);
+				count = available / task.stride;
+				count = (count < iCount - item) ? count : iCount - item;
+				used = count * task.stride;
+			}
+			else {
+				// index complete items of variable length by blocks
+				available = sourceEnsure(source, chunkSize);
+				items = source->buffer + source->bufferPos;
+				count = 0;
+				used = 0;
+				while (item + count < iCount && count / MUPLY_INDEX_BLOCK < indexCapacity) {
+					if (!(count % MUPLY_INDEX_BLOCK)) {
+						task.blockOffsets[count / MUPLY_INDEX_BLOCK] = used;
+						memcpy(task.blockStarts + (count / MUPLY_INDEX_BLOCK) * pCount, cursors, pCount * sizeof(size_t));
+					}
+					size_t itemEnd = used;
+					bool complete = true;
+					for (size_t p = 0; p < pCount && complete; ++p) {
+						listElements = 1;
+						if (props[p].listType != PlyType::NONE) {
+							listTypeSize = PlyTypeSizes[props[p].listType];
+							if (itemEnd + listTypeSize > available) {
+								complete = false;
+								break;
+							}
+							listElements = readListLength(items + itemEnd, props[p].listType, task.swap);
+							itemEnd += listTypeSize;
+						}
+						lengths[p] = (size_t)listElements;
+						itemSize = PlyTypeSizes[props[p].type];
+						itemEnd += (size_t)listElements * itemSize;
+						complete = (itemEnd <= available);
+					}
+					if (!complete) {
+						break;
+					}
+					// advance output positions of requested properties
+					for (size_t p = 0; p < pCount; ++p) {
+						if (props[p].data) {
+							cursors[p] += lengths[p];
+						}
+					}
+					used = itemEnd;
+					++count;
+				}
+			}
+			if (!count) {
+				// grow chunk for oversized items or stop at the end of data
+				if (fixedLength || available < chunkSize) {
+					success = false;
+					break;
+				}
+				chunkSize *= 2;
+				continue;
+			}
+			// grow property buffers if list sizes were underestimated
+			for (size_t p = 0; p < pCount; ++p) {
+				if (props[p].data && props[p].listType != PlyType::NONE) {
+					itemSize = PlyTypeSizes[props[p].type];
+					if ((long)(cursors[p] * itemSize) > capacities[p]) {
+						capacities[p] = (long)(cursors[p] * itemSize) + capacities[p] / 2;
+						props[p].data = realloc(props[p].data, capacities[p]);
+					}
+				}
+			}
+			// decode staged items in parallel
+			task.items = source->buffer + source->bufferPos;
+			task.firstItem = item;
+			task.itemCount = count;
+			threads = resolveThreadCount(file->threadCount, count);
+			if (fixedLength) {
+				runParallel(decodeFixedStaged, &task, threads);
+			}
+			else {
+				task.blockCount = (count + MUPLY_INDEX_BLOCK - 1) / MUPLY_INDEX_BLOCK;
+				threads = (threads < task.blockCount) ? threads : task.blockCount;
+				runParallel(decodeListStaged, &task, threads);
+			}
+			source->bufferPos += used;
+			item += count;
+		}
+		if (fixedLength) {
+			for (size_t p = 0; p < pCount; ++p) {
+				cursors[p] = item;
+			}
+		}
+		free(lengths);
+	}
+	// set final property sizes and merge statistics of threads
+	for (size_t p = 0; p < pCount; ++p) {
+		if (props[p].data) {
+			props[p].propertySize = (long)(cursors[p] * PlyTypeSizes[props[p].type]);
+			if (task.statistics) {
+				props[p].statistics = PlyStatistics();
+				for (size_t t = 0; t < maxThreads; ++t) {
+					mergeStatistics(&props[p].statistics, task.statistics + t * pCount + p);
+				}
+			}
+		}
+	}
+	free(task.statistics);
+	free(task.offsets);
+	free(task.segmentStarts);
+	free(task.segmentSizes);
+	free(task.packedOffsets);
+	free(task.blockOffsets);
+	free(task.blockStarts);
+	free(capacities);
+	free(cursors);
+	// start of next element is known now
+	if (success && elemIdx + 1 < (size_t)file->elementCount) {
+		file->elements[elemIdx + 1].dataStart = sourceTell(source);
+	}
+	return success;
+}
+
+void decodeValues(const char* src, const size_t stride, const size_t count, char* dst, const size_t size, const bool swap) {
+	// switch over value size to allow inlined copies
+	switch (size) {
+	case 1:
+		for (size_t i = 0; i < count; ++i) {
+			dst[i] = src[i * stride];
+		}
+		break;
+	case 2: {
+		uint16_t val;
+		uint16_t* dst16 = (uint16_t*)dst;
+		for (size_t i = 0; i < count; ++i) {
+			memcpy(&val, src + i * stride, sizeof(val));
+			dst16[i] = swap ? byteSwapValue16(val) : val;
+		}
+		break;
+	}
+	case 4: {
+		uint32_t val;
+		uint32_t* dst32 = (uint32_t*)dst;
+		for (size_t i = 0; i < count; ++i) {
+			memcpy(&val, src + i * stride, sizeof(val));
+			dst32[i] = swap ? byteSwapValue32(val) : val;
+		}
+		break;
+	}
+	case 8: {
+		uint64_t val;
+		uint64_t* dst64 = (uint64_t*)dst;
+		for (size_t i = 0; i < count; ++i) {
+			memcpy(&val, src + i * stride, sizeof(val));
+			dst64[i] = swap ? byteSwapValue64(val) : val;
+		}
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+bool requiresStatistics(const PlyFile* file, const size_t elemIdx) {
+	if (file->computeStatistics) {
+		return true;
+	}
+	// fixed point quantization requires the value range
+	const PlyElement elem = file->elements[elemIdx];
+	for (size_t p = 0; p < elem.propertyCount; ++p) {
+		if (elem.properties[p].data && elem.properties[p].quantization != QUANT_NONE) {
+			return true;
+		}
+	}
+	return false;
+}
+
+template <typename T>
+static void accumulateValues(const T* values, const size_t count, PlyStatistics* stats) {
+	double minVal = stats->min;
+	double maxVal = stats->max;
+	double sum = 0.0;
+	double val;
+	size_t nanCount = 0;
+	for (size_t i = 0; i < count; ++i) {
+		val = (double)values[i];
+		// NaNs are counted separately
+		if (val != val) {
+			++nanCount;
+			continue;
+		}
+		minVal = (val < minVal) ? val : minVal;
+		maxVal = (val > maxVal) ? val : maxVal;
+		sum += val;
+	}
+	stats->min = minVal;
+	stats->max = maxVal;
+	stats->sum += sum;
+	stats->count += count - nanCount;
+	stats->nanCount += nanCount;
+}
+
+void accumulateStatistics(const void* data, const PlyType type, const size_t count, PlyStatistics* stats) {
+	switch (type) {
+	case PlyType::INT8:
+		accumulateValues((const int8_t*)data, count, stats);
+		break;
+	case PlyType::INT16:
+		accumulateValues((const int16_t*)data, count, stats);
+		break;
+	case PlyType::INT32:
+		accumulateValues((const int32_t*)data, count, stats);
+		break;
+	case PlyType::INT64:
+		accumulateValues((const int64_t*)data, count, stats);
+		break;
+	case PlyType::UINT8:
+		accumulateValues((const uint8_t*)data, count, stats);
+		break;
+	case PlyType::UINT16:
+		accumulateValues((const uint16_t*)data, count, stats);
+		break;
+	case PlyType::UINT32:
+		accumulateValues((const uint32_t*)data, count, stats);
+		break;
+	case PlyType::UINT64:
+		accumulateValues((const uint64_t*)data, count, stats);
+		break;
+	case PlyType::FLOAT32:
+		accumulateValues((const float*)data, count, stats);
+		break;
+	case PlyType::FLOAT64:
+		accumulateValues((const double*)data, count, stats);
+		break;
+	default:
+		break;
+	}
+}
+
+void mergeStatistics(PlyStatistics* target, const PlyStatistics* source) {
+	target->min = (source->min < target->min) ? source->min : target->min;
+	target->max = (source->max > target->max) ? source->max : target->max;
+	target->sum += source->sum;
+	target->count += source->count;
+	target->nanCount += source->nanCount;
+}
+
+double statisticsMean(const PlyStatistics* stats) {
+	return stats->count ? stats->sum / (double)stats->count : NAN;
+}
+
+bool reorderElement(PlyFile* file, const char* element, const char* x, const char* y, const char* z,
+	const PlyCurve curve, const char* faceElement, const char* indexProperty) {
+	// get coordinate properties
+	const int elemIdx = findElement(file, element);
+	if (elemIdx == -1) {
+		return false;
+	}
+	PlyElement* elem = file->elements + elemIdx;
+	const size_t iCount = elem->itemCount;
+	const int coordIdx[3] = { findProperty(elem, x), findProperty(elem, y), findProperty(elem, z) };
+	for (int c = 0; c < 3; ++c) {
+		// components of octahedral normals are no coordinates
+		if (coordIdx[c] == -1 || !elem->properties[coordIdx[c]].data || elem->properties[coordIdx[c]].listType != PlyType::NONE ||
+			elem->properties[coordIdx[c]].dataQuantization == QUANT_OCT8) {
+			return false;
+		}
+	}
+	// indices are stored with 32bit
+	if (iCount > (size_t)UINT32_MAX) {
+		return false;
+	}
+	// get index lists of faces
+	PlyProperty* faceProp = NULL;
+	if (faceElement) {
+		const int faceIdx = findElement(file, faceElement);
+		if (faceIdx == -1) {
+			return false;
+		}
+		const int indexIdx = findProperty(file->elements + faceIdx, indexProperty);
+		if (indexIdx == -1) {
+			return false;
+		}
+		faceProp = file->elements[faceIdx].properties + indexIdx;
+		if (!faceProp->data || faceProp->listType == PlyType::NONE) {
+			return false;
+		}
+	}
+	const size_t threads = resolveThreadCount(file->threadCount, iCount);
+	// get bounding box, statistics are missing if not computed while reading
+	PlyCodeTask codeTask;
+	PlyStatistics stats;
+	for (int c = 0; c < 3; ++c) {
+		const PlyProperty* prop = elem->properties + coordIdx[c];
+		stats = prop->statistics;
+		if (!stats.count) {
+			accumulateStatistics(prop->data, prop->type, iCount, &stats);
+		}
+		codeTask.coords[c] = prop;
+		codeTask.mins[c] = stats.count ? stats.min : 0.0;
+		codeTask.scales[c] = (stats.count && stats.max > stats.min) ? 2097151.0 / (stats.max - stats.min) : 0.0;
+	}
+	// compute curve codes and sort items
+	uint64_t* keys = (uint64_t*)malloc(2 * iCount * sizeof(uint64_t));
+	uint32_t* order = (uint32_t*)malloc(2 * iCount * sizeof(uint32_t));
+	codeTask.curve = curve;
+	codeTask.keys = keys;
+	codeTask.values = order;
+	codeTask.count = iCount;
+	runParallel(computeCurveCodes, &codeTask, threads);
+	radixSort(keys, order, keys + iCount, order + iCount, iCount, threads);
+	free(keys);
+	// permute element and remap face indices
+	permuteProperties(file, elemIdx, order, iCount, threads);
+	if (faceProp) {
+		uint32_t* map = order + iCount;
+		for (size_t i = 0; i < iCount; ++i) {
+			map[order[i]] = (uint32_t)i;
+		}
+		remapIndices(faceProp->data, faceProp->type, faceProp->propertySize / PlyTypeSizes[faceProp->type], map, iCount, threads);
+	}
+	free(order);
+	return true;
+}
+
+/*
+* Arguments of welding tasks.
+*/
+struct PlyWeldTask {
+	// compared properties
+	const PlyProperty** keys = NULL;
+	// number of compared properties
+	size_t keyCount = 0;
+	// cell size for snapping values, 0 for exact comparison
+	double epsilon = 0.0;
+	// hash of each item
+	uint64_t* hashes = NULL;
+	// open-addressing table holding hash tags and item indices
+	std::atomic<uint64_t>* slots = NULL;
+	// capacity of table minus one
+	size_t mask = 0;
+	// index of kept item for each item
+	uint32_t* reps = NULL;
+	// number of items
+	size_t count = 0;
+};
+
+static uint64_t weldKey(const PlyWeldTask* task, const size_t key, const size_t idx) {
+	const PlyProperty* prop = task->keys[key];
+	uint64_t val = 0;
+	float val32f;
+	double val64f;
+	// snap values to grid cells
+	if (task->epsilon > 0.0) {
+		val64f = getValue(prop->data, prop->type, idx);
+		return (val64f == val64f) ? (uint64_t)(int64_t)floor(val64f / task->epsilon + 0.5) : MUPLY_WELD_EMPTY;
+	}
+	// compare raw bits with both signs of zero being equal
+	switch (prop->type) {
+	case PlyType::FLOAT32:
+		val32f = ((const float*)prop->data)[idx] + 0.0f;
+		memcpy(&val, &val32f, sizeof(val32f));
+		break;
+	case PlyType::FLOAT64:
+		val64f = ((const double*)prop->data)[idx] + 0.0;
+		memcpy(&val, &val64f, sizeof(val64f));
+		break;
+	default:
+		memcpy(&val, (const char*)prop->data + idx * PlyTypeSizes[prop->type], PlyTypeSizes[prop->type]);
+		break;
+	}
+	return val;
+}
+
+static bool equalItems(const PlyWeldTask* task, const size_t a, const size_t b) {
+	for (size_t k = 0; k < task->keyCount; ++k) {
+		if (weldKey(task, k, a) != weldKey(task, k, b)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static void insertItems(void* args, size_t thread, size_t threads) {
+	// hash items and insert them, equal items keep the smallest index
+	PlyWeldTask* task = (PlyWeldTask*)args;
+	const size_t first = task->count * thread / threads;
+	const size_t last = task->count * (thread + 1) / threads;
+	uint64_t hash, entry, current;
+	size_t pos;
+	for (size_t i = first; i < last; ++i) {
+		hash = 0;
+		for (size_t k = 0; k < task->keyCount; ++k) {
+			hash = hashValue(hash ^ (weldKey(task, k, i) + k));
+		}
+		task->hashes[i] = hash;
+		entry = (hash & 0xFFFFFFFF00000000ull) | i;
+		pos = (size_t)hash & task->mask;
+		while (true) {
+			current = task->slots[pos].load();
+			if (current == MUPLY_WELD_EMPTY) {
+				if (task->slots[pos].compare_exchange_weak(current, entry)) {
+					break;
+				}
+				continue;
+			}
+			if ((current >> 32) == (hash >> 32) && equalItems(task, current & 0xFFFFFFFF, i)) {
+				while (i < (current & 0xFFFFFFFF) && !task->slots[pos].compare_exchange_weak(current, entry)) {
+				}
+				break;
+			}
+			pos = (pos + 1) & task->mask;
 		}
 	}
-	// restore property sizes after abusing them
-	for (size_t p = 0; p < pCount; ++p) {
-		prop = props[p];
-		if (prop.data) {
-			props[p].propertySize *= (long)PlyTypeSizes[prop.type];
+}
+
+static void findItems(void* args, size_t thread, size_t threads) {
+	// look up kept item of each item
+	PlyWeldTask* task = (PlyWeldTask*)args;
+	const size_t first = task->count * thread / threads;
+	const size_t last = task->count * (thread + 1) / threads;
+	uint64_t hash, current;
+	size_t pos;
+	for (size_t i = first; i < last; ++i) {
+		hash = task->hashes[i];
+		pos = (size_t)hash & task->mask;
+		while (true) {
+			current = task->slots[pos].load(std::memory_order_relaxed);
+			if ((current >> 32) == (hash >> 32) && equalItems(task, current & 0xFFFFFFFF, i)) {
+				task->reps[i] = (uint32_t)(current & 0xFFFFFFFF);
+				break;
+			}
+			pos = (pos + 1) & task->mask;
 		}
 	}
 }
 
-void readPropertiesBinary(PlyFile* file, const size_t elemIdx) {
-	// setup properties and jump to element block
-	PlyElement elem = file->elements[elemIdx];
-	PlyProperty* props = elem.properties;
-	const size_t iCount = elem.itemCount;
-	const size_t pCount = elem.propertyCount;
-	fseek(file->file, elem.dataStart, SEEK_SET);
-	// setup position indices for the properties
-	for (size_t p = 0; p < pCount; ++p) {
-		props[p].propertySize = 0;
+bool weldElement(PlyFile* file, const char* element, const size_t n, const char* const* properties, const double epsilon,
+	const char* faceElement, const char* indexProperty, const bool dropUnreferenced) {
+	const int elemIdx = findElement(file, element);
+	if (elemIdx == -1) {
+		return false;
 	}
-	// prepare properties
-	int64_t listElements = 0;
-	size_t readSize, pIdx;
-	int8_t* data;
-	PlyProperty prop;
-	// read data
+	PlyElement* elem = file->elements + elemIdx;
+	const size_t iCount = elem->itemCount;
+	// indices are stored with 32bit, the largest index marks empty slots
+	if (iCount >= (size_t)UINT32_MAX) {
+		return false;
+	}
+	// get compared properties
+	PlyWeldTask task;
+	task.keys = (const PlyProperty**)malloc((elem->propertyCount + 1) * sizeof(PlyProperty*));
+	for (size_t p = 0; p < elem->propertyCount && !n; ++p) {
+		const PlyProperty* prop = elem->properties + p;
+		if (prop->data && prop->listType == PlyType::NONE && prop->dataQuantization == QUANT_NONE) {
+			task.keys[task.keyCount++] = prop;
+		}
+	}
+	for (size_t k = 0; k < n; ++k) {
+		const int propIdx = findProperty(elem, properties[k]);
+		const PlyProperty* prop = (propIdx != -1) ? elem->properties + propIdx : NULL;
+		if (!prop || !prop->data || prop->listType != PlyType::NONE || prop->dataQuantization != QUANT_NONE) {
+			free(task.keys);
+			return false;
+		}
+		task.keys[task.keyCount++] = prop;
+	}
+	// get index lists of faces
+	PlyProperty* faceProp = NULL;
+	if (faceElement) {
+		const int faceIdx = findElement(file, faceElement);
+		const int indexIdx = (faceIdx != -1) ? findProperty(file->elements + faceIdx, indexProperty) : -1;
+		faceProp = (indexIdx != -1) ? file->elements[faceIdx].properties + indexIdx : NULL;
+		if (!faceProp || !faceProp->data || faceProp->listType == PlyType::NONE) {
+			free(task.keys);
+			return false;
+		}
+	}
+	if (!task.keyCount) {
+		free(task.keys);
+		return false;
+	}
+	const size_t threads = resolveThreadCount(file->threadCount, iCount);
+	// setup table with a load factor of at most one half
+	size_t capacity = 16;
+	while (capacity < 2 * iCount) {
+		capacity *= 2;
+	}
+	task.epsilon = epsilon;
+	task.count = iCount;
+	task.mask = capacity - 1;
+	task.hashes = (uint64_t*)malloc((iCount + 1) * sizeof(uint64_t));
+	task.reps = (uint32_t*)malloc((iCount + 1) * sizeof(uint32_t));
+	task.slots = (std::atomic<uint64_t>*)malloc(capacity * sizeof(std::atomic<uint64_t>));
+	for (size_t s = 0; s < capacity; ++s) {
+		task.slots[s].store(MUPLY_WELD_EMPTY, std::memory_order_relaxed);
+	}
+	runParallel(insertItems, &task, threads);
+	runParallel(findItems, &task, threads);
+	free(task.slots);
+	free(task.hashes);
+	free(task.keys);
+	// mark kept items referenced by faces
+	const uint32_t* reps = task.reps;
+	uint8_t* referenced = NULL;
+	size_t indexCount = 0;
+	if (faceProp) {
+		indexCount = faceProp->propertySize / PlyTypeSizes[faceProp->type];
+	}
+	if (faceProp && dropUnreferenced) {
+		referenced = (uint8_t*)calloc(iCount + 1, sizeof(uint8_t));
+		for (size_t i = 0; i < indexCount; ++i) {
+			const uint64_t idx = (uint64_t)getValue(faceProp->data, faceProp->type, i);
+			if (idx < iCount) {
+				referenced[reps[idx]] = 1;
+			}
+		}
+	}
+	// assign new indices to kept items in their original order
+	uint32_t* order = (uint32_t*)malloc((iCount + 1) * sizeof(uint32_t));
+	uint32_t* map = (uint32_t*)malloc((iCount + 1) * sizeof(uint32_t));
+	size_t count = 0;
 	for (size_t i = 0; i < iCount; ++i) {
-		for (size_t p = 0; p < pCount; ++p) {
-			prop = props[p];
-			if (prop.data) {				
-				listElements = 1;
-				pIdx = prop.propertySize;
-				if (prop.listType != PlyType::NONE) {
-					data = (int8_t*)prop.listData;
-					readSize = PlyTypeSizes[prop.listType];
-					fread(&listElements, readSize, 1, file->file);
-					memcpy(data + i * readSize, &listElements, readSize);
-				}
-				// read requested property
-				data = (int8_t*)prop.data;
-				readSize = PlyTypeSizes[prop.type];
-				fread(data + pIdx * readSize, readSize, listElements, file->file);
+		if (reps[i] == i && (!referenced || referenced[i])) {
+			map[i] = (uint32_t)count;
+			order[count++] = (uint32_t)i;
+		}
+		else {
+			// mark dropped items, duplicates take the index of their kept item below
+			map[i] = UINT32_MAX;
+		}
+	}
+	for (size_t i = 0; i < iCount; ++i) {
+		map[i] = map[reps[i]];
+	}
+	free(referenced);
+	free(task.reps);
+	// compact element and remap face indices
+	permuteProperties(file, elemIdx, order, count, threads);
+	if (faceProp) {
+		remapIndices(faceProp->data, faceProp->type, indexCount, map, iCount, threads);
+	}
+	free(order);
+	free(map);
+	// refresh statistics of compacted properties
+	for (size_t p = 0; p < elem->propertyCount; ++p) {
+		PlyProperty* prop = elem->properties + p;
+		if (prop->data && prop->statistics.count && prop->listType == PlyType::NONE && prop->dataQuantization == QUANT_NONE) {
+			prop->statistics = PlyStatistics();
+			accumulateStatistics(prop->data, prop->type, count, &prop->statistics);
+		}
+	}
+	return true;
+}
+
+uint64_t hashValue(uint64_t val) {
+	// finalizer of murmur3
+	val ^= val >> 33;
+	val *= 0xFF51AFD7ED558CCDull;
+	val ^= val >> 33;
+	val *= 0xC4CEB9FE1A85EC53ull;
+	val ^= val >> 33;
+	return val;
+}
+
+static uint64_t spreadBits(uint64_t val) {
+	// insert two zero bits between each of the lower 21 bits
+	val &= 0x1FFFFF;
+	val = (val | (val << 32)) & 0x1F00000000FFFFull;
+	val = (val | (val << 16)) & 0x1F0000FF0000FFull;
+	val = (val | (val << 8)) & 0x100F00F00F00F00Full;
+	val = (val | (val << 4)) & 0x10C30C30C30C30C3ull;
+	val = (val | (val << 2)) & 0x1249249249249249ull;
+	return val;
+}
+
+uint64_t mortonCode(const uint32_t x, const uint32_t y, const uint32_t z) {
+	return spreadBits(x) | (spreadBits(y) << 1) | (spreadBits(z) << 2);
+}
+
+uint64_t hilbertCode(const uint32_t x, const uint32_t y, const uint32_t z) {
+	// transpose coordinates into hilbert order, see Skilling (2004)
+	uint32_t X[3] = { x & 0x1FFFFF, y & 0x1FFFFF, z & 0x1FFFFF };
+	uint32_t P, Q, t;
+	for (Q = 1u << 20; Q > 1; Q >>= 1) {
+		P = Q - 1;
+		for (int i = 0; i < 3; ++i) {
+			if (X[i] & Q) {
+				X[0] ^= P;
 			}
 			else {
-				// skip unrequested property
-				readSize = PlyTypeSizes[prop.type] * listElements;
-				fseek(file->file, (long)readSize, SEEK_CUR);
+				t = (X[0] ^ X[i]) & P;
+				X[0] ^= t;
+				X[i] ^= t;
 			}
-			props[p].propertySize += (long)listElements;
 		}
 	}
-	// restore property sizes after abusing them
-	for (size_t p = 0; p < pCount; ++p) {
-		prop = props[p];
-		if (prop.data) {
-			props[p].propertySize *= (long)PlyTypeSizes[prop.type];
+	// gray encode
+	X[1] ^= X[0];
+	X[2] ^= X[1];
+	t = 0;
+	for (Q = 1u << 20; Q > 1; Q >>= 1) {
+		if (X[2] & Q) {
+			t ^= Q - 1;
+		}
+	}
+	X[0] ^= t;
+	X[1] ^= t;
+	X[2] ^= t;
+	// interleave transposed bits, first coordinate is most significant
+	return (spreadBits(X[0]) << 2) | (spreadBits(X[1]) << 1) | spreadBits(X[2]);
+}
+
+void radixSort(uint64_t* keys, uint32_t* values, uint64_t* tempKeys, uint32_t* tempValues, const size_t count, const size_t threads) {
+	PlySortTask task;
+	task.keys[0] = keys;
+	task.keys[1] = tempKeys;
+	task.values[0] = values;
+	task.values[1] = tempValues;
+	task.count = count;
+	task.counts = (size_t*)malloc(threads * 256 * sizeof(size_t));
+	size_t offset, total;
+	bool trivial;
+	for (task.shift = 0; task.shift < 64; task.shift += 8) {
+		memset(task.counts, 0, threads * 256 * sizeof(size_t));
+		runParallel(radixHistogram, &task, threads);
+		// skip digits shared by all keys
+		trivial = false;
+		for (size_t d = 0; d < 256 && !trivial; ++d) {
+			total = 0;
+			for (size_t t = 0; t < threads; ++t) {
+				total += task.counts[t * 256 + d];
+			}
+			trivial = (total == count);
+		}
+		if (trivial) {
+			continue;
+		}
+		// turn histograms into scatter offsets, ordered by digit and thread
+		offset = 0;
+		for (size_t d = 0; d < 256; ++d) {
+			for (size_t t = 0; t < threads; ++t) {
+				total = task.counts[t * 256 + d];
+				task.counts[t * 256 + d] = offset;
+				offset += total;
+			}
+		}
+		runParallel(radixScatter, &task, threads);
+		uint64_t* swapKeys = task.keys[0];
+		task.keys[0] = task.keys[1];
+		task.keys[1] = swapKeys;
+		uint32_t* swapValues = task.values[0];
+		task.values[0] = task.values[1];
+		task.values[1] = swapValues;
+	}
+	// move result back if necessary
+	if (task.keys[0] != keys) {
+		memcpy(keys, task.keys[0], count * sizeof(uint64_t));
+		memcpy(values, task.values[0], count * sizeof(uint32_t));
+	}
+	free(task.counts);
+}
+
+void permuteProperties(PlyFile* file, const size_t elemIdx, const uint32_t* order, const size_t count, const size_t threads) {
+	PlyElement elem = file->elements[elemIdx];
+	PlyProperty* props = elem.properties;
+	const size_t iCount = elem.itemCount;
+	PlyGatherTask task;
+	task.order = order;
+	task.count = count;
+	for (size_t p = 0; p < elem.propertyCount; ++p) {
+		PlyProperty* prop = props + p;
+		if (!prop->data) {
+			continue;
 		}
-	}	
+		if (prop->listType != PlyType::NONE) {
+			// permute list entries by their offsets
+			const size_t listTypeSize = PlyTypeSizes[prop->listType];
+			const size_t itemSize = PlyTypeSizes[prop->type];
+			size_t* offsets = (size_t*)malloc((iCount + 1) * sizeof(size_t));
+			offsets[0] = 0;
+			for (size_t i = 0; i < iCount; ++i) {
+				offsets[i + 1] = offsets[i] + (size_t)readListLength((char*)prop->listData + i * listTypeSize, prop->listType, false) * itemSize;
+			}
+			char* data = (char*)malloc(prop->propertySize);
+			char* listData = (char*)malloc(count * listTypeSize);
+			size_t pos = 0;
+			for (size_t i = 0; i < count; ++i) {
+				memcpy(data + pos, (char*)prop->data + offsets[order[i]], offsets[order[i] + 1] - offsets[order[i]]);
+				memcpy(listData + i * listTypeSize, (char*)prop->listData + order[i] * listTypeSize, listTypeSize);
+				pos += offsets[order[i] + 1] - offsets[order[i]];
+			}
+			free(prop->data);
+			free(prop->listData);
+			free(offsets);
+			prop->data = data;
+			prop->listData = listData;
+			prop->propertySize = (long)pos;
+			continue;
+		}
+		// get bytes per item of raw or quantized data
+		switch (prop->dataQuantization) {
+		case QUANT_FIXED16:
+		case QUANT_OCT8:
+			task.size = 2;
+			prop->propertySize = (long)(2 * count);
+			break;
+		case QUANT_FIXED21:
+			task.size = 0;
+			prop->propertySize = (long)(((count + 2) / 3) * sizeof(uint64_t));
+			break;
+		default:
+			task.size = PlyTypeSizes[prop->type];
+			prop->propertySize = (long)(count * task.size);
+			break;
+		}
+		task.src = (const char*)prop->data;
+		task.dst = (char*)malloc(prop->propertySize ? prop->propertySize : 1);
+		runParallel(gatherItems, &task, threads);
+		free(prop->data);
+		prop->data = task.dst;
+	}
+	file->elements[elemIdx].itemCount = count;
+}
+
+void remapIndices(void* data, const PlyType type, const size_t count, const uint32_t* map, const size_t mapCount, const size_t threads) {
+	PlyRemapTask task;
+	task.data = data;
+	task.type = type;
+	task.count = count;
+	task.map = map;
+	task.mapCount = mapCount;
+	runParallel(remapRange, &task, threads);
+}
+
+int64_t readListLength(const char* ptr, const PlyType type, const bool swap) {
+	uint16_t val16;
+	uint32_t val32;
+	uint64_t val64;
+	switch (type) {
+	case PlyType::INT8:
+		return *(const int8_t*)ptr;
+	case PlyType::UINT8:
+		return *(const uint8_t*)ptr;
+	case PlyType::INT16:
+	case PlyType::UINT16:
+		memcpy(&val16, ptr, sizeof(val16));
+		val16 = swap ? byteSwapValue16(val16) : val16;
+		return (type == PlyType::INT16) ? (int64_t)(int16_t)val16 : (int64_t)val16;
+	case PlyType::INT32:
+	case PlyType::UINT32:
+		memcpy(&val32, ptr, sizeof(val32));
+		val32 = swap ? byteSwapValue32(val32) : val32;
+		return (type == PlyType::INT32) ? (int64_t)(int32_t)val32 : (int64_t)val32;
+	case PlyType::INT64:
+	case PlyType::UINT64:
+		memcpy(&val64, ptr, sizeof(val64));
+		return (int64_t)(swap ? byteSwapValue64(val64) : val64);
+	default:
+		return 0;
+	}
+}
+
+size_t resolveThreadCount(const int threadCount, const size_t itemCount) {
+	const unsigned int hardwareThreads = std::thread::hardware_concurrency();
+	size_t threads = (threadCount > 0) ? (size_t)threadCount : (hardwareThreads ? hardwareThreads : 1);
+	// avoid threads with too little work
+	if (itemCount) {
+		const size_t itemThreads = itemCount / MUPLY_THREAD_MIN_ITEMS;
+		threads = (itemThreads < threads) ? itemThreads : threads;
+		threads = threads ? threads : 1;
+	}
+	return threads;
+}
+
+void runParallel(void (*task)(void* args, size_t thread, size_t threads), void* args, const size_t threads) {
+	// spawn workers and run first task on calling thread
+	std::thread* workers = new std::thread[threads];
+	for (size_t t = 1; t < threads; ++t) {
+		workers[t] = std::thread(task, args, t, threads);
+	}
+	task(args, 0, threads);
+	for (size_t t = 1; t < threads; ++t) {
+		workers[t].join();
+	}
+	delete[] workers;
 }
 
 void byteSwapProperties(PlyFile* file, const size_t elemIdx) {
@@ -682,6 +4010,9 @@ void byteSwapProperties(PlyFile* file, const size_t elemIdx) {
 	size_t iCount;
 	for (size_t p = 0; p < pCount; ++p) {
 		prop = props[p];
+		if (!prop.data || prop.dataQuantization != QUANT_NONE) {
+			continue;
+		}
 		iCount = prop.propertySize / PlyTypeSizes[prop.type];
 		switch (prop.type) {
 		case PlyType::INT16:
@@ -704,3 +4035,323 @@ void byteSwapProperties(PlyFile* file, const size_t elemIdx) {
 		}
 	}
 }
+
+void initSource(PlySource* source) {
+	// in-memory sources already hold their content
+	if (!source->buffer && source->read) {
+		source->bufferSize = MUPLY_SOURCE_BUFFER_SIZE;
+		source->buffer = (char*)malloc(source->bufferSize);
+		source->ownsBuffer = true;
+	}
+	source->bufferPos = 0;
+	source->bufferFill = source->read ? 0 : source->bufferFill;
+	source->bufferOffset = 0;
+}
+
+void closeSource(PlySource* source) {
+	if (source->close) {
+		source->close(source->handle);
+	}
+	if (source->ownsBuffer) {
+		free(source->buffer);
+	}
+	*source = PlySource();
+}
+
+bool sourceSeekable(const PlySource* source) {
+	return source->seek || !source->read;
+}
+
+long sourceTell(const PlySource* source) {
+	return source->bufferOffset + (long)source->bufferPos;
+}
+
+bool sourceFill(PlySource* source) {
+	// in-memory sources cannot be refilled
+	if (!source->read) {
+		return false;
+	}
+	source->bufferOffset += (long)source->bufferFill;
+	source->bufferPos = 0;
+	source->bufferFill = source->read(source->handle, source->buffer, source->bufferSize);
+	return source->bufferFill > 0;
+}
+
+size_t sourceRead(PlySource* source, void* buffer, const size_t size) {
+	char* target = (char*)buffer;
+	size_t total = 0;
+	size_t chunk;
+	while (total < size) {
+		if (source->bufferPos == source->bufferFill) {
+			// read large blocks directly into target
+			if (source->read && (size - total >= source->bufferSize)) {
+				source->bufferOffset += (long)source->bufferFill;
+				source->bufferPos = 0;
+				source->bufferFill = 0;
+				chunk = source->read(source->handle, target + total, size - total);
+				source->bufferOffset += (long)chunk;
+				total += chunk;
+				if (!chunk) {
+					break;
+				}
+				continue;
+			}
+			if (!sourceFill(source)) {
+				break;
+			}
+		}
+		// copy buffered data
+		chunk = source->bufferFill - source->bufferPos;
+		chunk = (chunk < size - total) ? chunk : size - total;
+		memcpy(target + total, source->buffer + source->bufferPos, chunk);
+		source->bufferPos += chunk;
+		total += chunk;
+	}
+	return total;
+}
+
+char* sourceGets(PlySource* source, char* line, const size_t size) {
+	size_t length = 0;
+	size_t chunk;
+	const char* lineEnd;
+	while (length + 1 < size) {
+		if (source->bufferPos == source->bufferFill && !sourceFill(source)) {
+			break;
+		}
+		// copy up to line break or end of buffered data
+		chunk = source->bufferFill - source->bufferPos;
+		chunk = (chunk < size - 1 - length) ? chunk : size - 1 - length;
+		lineEnd = (const char*)memchr(source->buffer + source->bufferPos, '\n', chunk);
+		if (lineEnd) {
+			chunk = lineEnd - (source->buffer + source->bufferPos) + 1;
+		}
+		memcpy(line + length, source->buffer + source->bufferPos, chunk);
+		source->bufferPos += chunk;
+		length += chunk;
+		if (lineEnd) {
+			break;
+		}
+	}
+	line[length] = '\0';
+	return length ? line : NULL;
+}
+
+size_t sourceEnsure(PlySource* source, const size_t size) {
+	size_t available = source->bufferFill - source->bufferPos;
+	// in-memory sources cannot be refilled
+	if (available >= size || !source->read) {
+		return available;
+	}
+	// move remaining data to buffer start
+	memmove(source->buffer, source->buffer + source->bufferPos, available);
+	source->bufferOffset += (long)source->bufferPos;
+	source->bufferPos = 0;
+	source->bufferFill = available;
+	// grow buffer if necessary
+	if (size > source->bufferSize) {
+		if (source->ownsBuffer) {
+			source->buffer = (char*)realloc(source->buffer, size);
+		}
+		else {
+			char* buffer = (char*)malloc(size);
+			memcpy(buffer, source->buffer, available);
+			source->buffer = buffer;
+			source->ownsBuffer = true;
+		}
+		source->bufferSize = size;
+	}
+	// fill buffer
+	size_t chunk;
+	while (source->bufferFill < size) {
+		chunk = source->read(source->handle, source->buffer + source->bufferFill, source->bufferSize - source->bufferFill);
+		if (!chunk) {
+			break;
+		}
+		source->bufferFill += chunk;
+	}
+	return source->bufferFill;
+}
+
+bool sourceSeek(PlySource* source, const long offset) {
+	// jump within buffered data
+	if (offset >= source->bufferOffset && offset <= source->bufferOffset + (long)source->bufferFill) {
+		source->bufferPos = (size_t)(offset - source->bufferOffset);
+		return true;
+	}
+	// jump by seeking the underlying source
+	if (source->seek) {
+		if (!source->seek(source->handle, offset)) {
+			return false;
+		}
+		source->bufferOffset = offset;
+		source->bufferPos = 0;
+		source->bufferFill = 0;
+		return true;
+	}
+	// forward-only sources can only skip ahead
+	if (offset < sourceTell(source)) {
+		return false;
+	}
+	while (sourceTell(source) < offset) {
+		if (source->bufferPos == source->bufferFill && !sourceFill(source)) {
+			return false;
+		}
+		const long remaining = offset - sourceTell(source);
+		const long available = (long)(source->bufferFill - source->bufferPos);
+		source->bufferPos += (size_t)((remaining < available) ? remaining : available);
+	}
+	return true;
+}
+
+bool sourceSkip(PlySource* source, const long count) {
+	return sourceSeek(source, sourceTell(source) + count);
+}
+
+size_t stageLines(PlySource* source, const size_t maxLines, size_t* chunkSize, size_t* used) {
+	size_t available, lines;
+	const char* start;
+	while (true) {
+		available = sourceEnsure(source, *chunkSize);
+		if (!available) {
+			return 0;
+		}
+		start = source->buffer + source->bufferPos;
+		lines = maxLines;
+		*used = (size_t)(findLines(start, available, &lines) - start);
+		if (lines) {
+			return lines;
+		}
+		// final line without line break
+		if (available < *chunkSize) {
+			*used = available;
+			return 1;
+		}
+		*chunkSize *= 2;
+	}
+}
+
+/*
+* Bit helpers for scanning masks.
+*/
+static int popCount(unsigned int mask) {
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_popcount(mask);
+#else
+	int count = 0;
+	for (; mask; mask &= mask - 1) {
+		++count;
+	}
+	return count;
+#endif
+}
+
+static int lowestBit(unsigned int mask) {
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_ctz(mask);
+#else
+	int bit = 0;
+	for (; !(mask & 1); mask >>= 1) {
+		++bit;
+	}
+	return bit;
+#endif
+}
+
+size_t countLines(const char* data, const size_t size) {
+	size_t lines = 0;
+	size_t i = 0;
+#ifdef MUPLY_SSE2
+	// classify 16 bytes at once
+	const __m128i newline = _mm_set1_epi8('\n');
+	for (; i + 16 <= size; i += 16) {
+		const __m128i block = _mm_loadu_si128((const __m128i*)(data + i));
+		lines += (size_t)popCount((unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(block, newline)));
+	}
+#endif
+	// scan remaining bytes
+	const char* pos = data + i;
+	const char* end = data + size;
+	while (pos < end && (pos = (const char*)memchr(pos, '\n', end - pos))) {
+		++lines;
+		++pos;
+	}
+	return lines;
+}
+
+const char* findLines(const char* data, const size_t size, size_t* lines) {
+	size_t remaining = *lines;
+	const char* last = data;
+	size_t i = 0;
+#ifdef MUPLY_SSE2
+	// classify 16 bytes at once and only resolve positions within the final block
+	const __m128i newline = _mm_set1_epi8('\n');
+	unsigned int mask;
+	size_t count;
+	for (; remaining && i + 16 <= size; i += 16) {
+		const __m128i block = _mm_loadu_si128((const __m128i*)(data + i));
+		mask = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(block, newline));
+		count = (size_t)popCount(mask);
+		if (count >= remaining) {
+			for (; remaining > 1; --remaining) {
+				mask &= mask - 1;
+			}
+			return data + i + lowestBit(mask) + 1;
+		}
+		if (count) {
+			remaining -= count;
+			for (; mask & (mask - 1); mask &= mask - 1) {
+			}
+			last = data + i + lowestBit(mask) + 1;
+		}
+	}
+#endif
+	// scan remaining bytes
+	const char* pos = data + i;
+	const char* end = data + size;
+	while (remaining && pos < end && (pos = (const char*)memchr(pos, '\n', end - pos))) {
+		last = ++pos;
+		--remaining;
+	}
+	*lines -= remaining;
+	return last;
+}
+
+const char* skipSpaces(const char* pos, const char* end) {
+	while (pos < end && (*pos == ' ' || *pos == '\t' || *pos == '\r')) {
+		++pos;
+	}
+	return pos;
+}
+
+const char* skipToken(const char* pos, const char* end) {
+#ifdef MUPLY_SSE2
+	// classify whitespace of 16 bytes at once
+	const __m128i space = _mm_set1_epi8(' ');
+	const __m128i tab = _mm_set1_epi8('\t');
+	const __m128i ret = _mm_set1_epi8('\r');
+	const __m128i newline = _mm_set1_epi8('\n');
+	unsigned int mask;
+	for (; pos + 16 <= end; pos += 16) {
+		const __m128i block = _mm_loadu_si128((const __m128i*)pos);
+		const __m128i ws = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, space), _mm_cmpeq_epi8(block, tab)),
+			_mm_or_si128(_mm_cmpeq_epi8(block, ret), _mm_cmpeq_epi8(block, newline)));
+		mask = (unsigned int)_mm_movemask_epi8(ws);
+		if (mask) {
+			return pos + lowestBit(mask);
+		}
+	}
+#endif
+	// scan remaining bytes
+	while (pos < end && *pos != ' ' && *pos != '\t' && *pos != '\r' && *pos != '\n') {
+		++pos;
+	}
+	return pos;
+}
+
+const char* copyToken(const char* pos, const char* tokenEnd, char* token) {
+	size_t length = (size_t)(tokenEnd - pos);
+	length = (length < MUPLY_TOKEN_SIZE - 1) ? length : MUPLY_TOKEN_SIZE - 1;
+	memcpy(token, pos, length);
+	token[length] = '\0';
+	return token;
+}
@@ -11,11 +11,34 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
+#include <math.h>
 
 // size of buffer for reading ascii data
 #define MUPLY_BUFFER_SIZE 256
+// size of read buffer of data sources
+#define MUPLY_SOURCE_BUFFER_SIZE 65536
+// size of read buffer used to probe headers, refilled only for longer headers
+#define MUPLY_PROBE_BUFFER_SIZE 4096
+// assumed average list length when list sizes are unknown
+#define MUPLY_LIST_ESTIMATE 3
+// number of bytes per chunk and thread for decoding binary data
+#define MUPLY_CHUNK_SIZE 1048576
+// number of items per block of the offset index of list elements
+#define MUPLY_INDEX_BLOCK 1024
+// minimum number of items per decoding thread
+#define MUPLY_THREAD_MIN_ITEMS 16384
+// number of digits reserved for item counts of headers written in a streaming fashion
+#define MUPLY_COUNT_WIDTH 20
+// marks unused slots of welding tables
+#define MUPLY_WELD_EMPTY UINT64_MAX
+// cost of a single read request on local storage, in bytes of sequential transfer
+#define MUPLY_LOCAL_REQUEST_COST 16384
+// cost of a single read request on network storage, in bytes of sequential transfer
+#define MUPLY_NETWORK_REQUEST_COST 1048576
 // delimiter tokens
 #define MUPLY_TOKEN_SEP " \r\n"
+// maximum length of a single ascii token
+#define MUPLY_TOKEN_SIZE 64
 
 /*
 * Data types.
@@ -54,6 +77,59 @@ enum PlyEncoding {
 	BINARY_BIG_ENDIAN
 };
 /*
+* String conversion table for encoding types.
+*/
+const char PlyEncodingStrings[4][21] = {
+	"unknown", "ascii", "binary_little_endian", "binary_big_endian"
+};
+/*
+* Quantization modes for compact in-memory storage of properties.
+*/
+enum PlyQuantization {
+	// raw values
+	QUANT_NONE,
+	// 16bit fixed point values with per-property scale and offset
+	QUANT_FIXED16,
+	// 21bit fixed point values with per-property scale and offset, three values packed per 64bit word
+	QUANT_FIXED21,
+	// octahedral normals with two 8bit components, stored with the x component
+	QUANT_OCT8
+};
+/*
+* Space-filling curves for spatial reordering.
+*/
+enum PlyCurve {
+	// z-order curve
+	CURVE_MORTON,
+	// hilbert curve
+	CURVE_HILBERT
+};
+/*
+* Kinds of storage behind a source, used to weigh read requests against transferred bytes.
+*/
+enum PlySourceKind {
+	// local storage like ssd or nvme drives
+	SOURCE_LOCAL,
+	// network mounts with high request latency
+	SOURCE_NETWORK
+};
+/*
+* Statistics of property values.
+* Minimum and maximum are only valid if count is greater than zero.
+*/
+struct PlyStatistics {
+	// smallest value
+	double min = HUGE_VAL;
+	// largest value
+	double max = -HUGE_VAL;
+	// sum of values
+	double sum = 0.0;
+	// number of values excluding NaNs
+	size_t count = 0;
+	// number of NaN values (floating point types only)
+	size_t nanCount = 0;
+};
+/*
 * Property fields.
 */
 struct PlyProperty {
@@ -72,6 +148,18 @@ struct PlyProperty {
 	void* data = NULL;
 	// size of property memory block
 	long propertySize = 0;
+	// value statistics (if computed while reading)
+	PlyStatistics statistics;
+	// quantization applied after reading
+	PlyQuantization quantization = QUANT_NONE;
+	// quantization of the loaded data, released components of normals keep QUANT_OCT8
+	PlyQuantization dataQuantization = QUANT_NONE;
+	// scale of fixed point values
+	double quantScale = 1.0;
+	// offset of fixed point values
+	double quantOffset = 0.0;
+	// indices of y and z components of octahedral normals, only set for the x component
+	int quantLinks[2] = { -1, -1 };
 };
 /*
 * Element fields.
@@ -83,6 +171,8 @@ struct PlyElement {
 	size_t nameLength = 0;
 	// number of items
 	size_t itemCount = 0;
+	// number of items in file, exceeds itemCount once loaded items are compacted
+	size_t fileItemCount = 0;
 	// properties of element
 	PlyProperty* properties = NULL;
 	// number of properties
@@ -91,11 +181,43 @@ struct PlyElement {
 	long dataStart = 0;
 };
 /*
+* Data source for reading ply data.
+* Sources are defined by callbacks working on an opaque handle.
+* Forward-only sources like pipes leave the seek callback undefined.
+* In-memory sources leave the read callback undefined and hold their entire content in the buffer.
+*/
+struct PlySource {
+	// source specific handle
+	void* handle = NULL;
+	// read up to size bytes from current position, returns number of bytes read
+	size_t (*read)(void* handle, void* buffer, size_t size) = NULL;
+	// jump to absolute offset, undefined for forward-only sources
+	bool (*seek)(void* handle, long offset) = NULL;
+	// thread-safe read of up to size bytes at absolute offset without moving the cursor, optional
+	size_t (*readAt)(void* handle, void* buffer, size_t size, long offset) = NULL;
+	// release handle, optional
+	void (*close)(void* handle) = NULL;
+	// kind of storage, hint for planning positioned reads
+	PlySourceKind kind = PlySourceKind::SOURCE_LOCAL;
+	// read buffer
+	char* buffer = NULL;
+	// size of read buffer
+	size_t bufferSize = 0;
+	// current position in read buffer
+	size_t bufferPos = 0;
+	// number of valid bytes in read buffer
+	size_t bufferFill = 0;
+	// absolute offset of read buffer start
+	long bufferOffset = 0;
+	// true, if buffer was allocated by source
+	bool ownsBuffer = false;
+};
+/*
 * Container for basic file information.
 */
 struct PlyFile {
-	// file pointer
-	FILE* file = NULL;
+	// data source
+	PlySource source;
 	// encoding type
 	PlyEncoding encoding = PlyEncoding::UNKNOWN;
 	// number of elements in file
@@ -104,6 +226,48 @@ struct PlyFile {
 	PlyElement* elements = NULL;
 	// start of data section
 	long dataStart = 0;
+	// number of threads for decoding, 0 to use all hardware threads
+	int threadCount = 0;
+	// compute statistics of requested properties while reading
+	bool computeStatistics = false;
+};
+/*
+* Batch of items streamed from an element.
+* Items are packed binary records in system endianness with properties in header order.
+* Lists are stored as list length followed by their entries.
+*/
+struct PlyBatch {
+	// packed item records
+	const char* items = NULL;
+	// offsets of item records within items, itemCount + 1 entries
+	const size_t* offsets = NULL;
+	// number of items in batch
+	size_t itemCount = 0;
+	// index of first item within element
+	size_t firstItem = 0;
+};
+/*
+* Settings for splitting an element into spatial grid tiles.
+*/
+struct PlyTiling {
+	// name of element to be tiled
+	const char* element = "vertex";
+	// names of coordinate properties
+	const char* coords[3] = { "x", "y", "z" };
+	// number of tiles per axis, use powers of two for octree levels
+	size_t tiles[3] = { 1, 1, 1 };
+	// true, if bounds are given, otherwise they are computed in a first pass
+	bool hasBounds = false;
+	// lower bounds of grid
+	double min[3] = { 0.0, 0.0, 0.0 };
+	// upper bounds of grid
+	double max[3] = { 0.0, 0.0, 0.0 };
+	// printf pattern of output paths, receives the tile indices as size_t
+	const char* pattern = "tile_%zu_%zu_%zu.ply";
+	// number of items per streamed batch
+	size_t batchSize = 65536;
+	// memory shared by the write buffers of all tiles
+	size_t bufferMemory = 64 * 1024 * 1024;
 };
 /*
 * Convert c-string to PlyEncoding.
@@ -141,6 +305,30 @@ void byteSwap32(void* ptr, const size_t elementCount);
 */
 void byteSwap64(void* ptr, const size_t elementCount);
 /*
+* Do byteswapping of a single 16bit value.
+* @param val Original value.
+* @return Byteswapped value.
+*/
+uint16_t byteSwapValue16(const uint16_t val);
+/*
+* Do byteswapping of a single 32bit value.
+* @param val Original value.
+* @return Byteswapped value.
+*/
+uint32_t byteSwapValue32(const uint32_t val);
+/*
+* Do byteswapping of a single 64bit value.
+* @param val Original value.
+* @return Byteswapped value.
+*/
+uint64_t byteSwapValue64(const uint64_t val);
+/*
+* Check if binary data of a file differs from system endianness.
+* @param file PlyFile for checking.
+* @return True, if binary data needs to be byteswapped.
+*/
+bool requiresByteSwap(const PlyFile* file);
+/*
 * Open file and get basic information from header section.
 * The PlyFile object will be reused for data queries.
 * @param path Path to file.
@@ -148,6 +336,97 @@ void byteSwap64(void* ptr, const size_t elementCount);
 */
 PlyFile openPly(const char* path);
 /*
+* Open in-memory ply data and get basic information from header section.
+* The buffer is not copied and must stay valid until closePly is called.
+* @param buffer Pointer to ply data.
+* @param size Size of buffer in bytes.
+* @return PlyFile object with basic file information. File information will be empty if loading failed.
+*/
+PlyFile openPlyBuffer(const void* buffer, const size_t size);
+/*
+* Open ply data from a file descriptor positioned at the start of the file.
+* Descriptors of pipes or sockets are read as forward-only sources.
+* The descriptor is not closed by closePly.
+* @param fd File descriptor for reading.
+* @return PlyFile object with basic file information. File information will be empty if loading failed.
+*/
+PlyFile openPlyFd(const int fd);
+/*
+* Open ply data from a forward-only stream, e.g. stdin or a pipe.
+* Elements have to be requested in file order and can only be requested once.
+* The stream is not closed by closePly.
+* @param stream Stream positioned at the start of the file.
+* @return PlyFile object with basic file information. File information will be empty if loading failed.
+*/
+PlyFile openPlyStream(FILE* stream);
+/*
+* Open ply data from a custom source and get basic information from header section.
+* Seekable sources are inspected immediately.
+* Forward-only sources are inspected lazily while elements are requested in file order.
+* The PlyFile object takes ownership of the source, which is closed on failure or by closePly.
+* @param source Source positioned at the start of the file.
+* @return PlyFile object with basic file information. File information will be empty if loading failed.
+*/
+PlyFile openPlySource(PlySource source);
+/*
+* Internally used to open a source and parse its header without inspecting the data section.
+* Only the start of the first element is known, offsets of following elements have to be set by the caller.
+* @param source Source positioned at the start of the file.
+* @return PlyFile object with basic file information. File information will be empty if loading failed.
+*/
+PlyFile openPlyHeader(PlySource source);
+/*
+* Internally used to setup a seekable source reading a file.
+* @param path Path to file.
+* @param source Receives the source.
+* @return True, if the file could be opened.
+*/
+bool openFileSource(const char* path, PlySource* source);
+/*
+* Read only the header of a file and get basic information without touching the data section.
+* Element names, item counts, property types and encoding are available.
+* Data offsets and list sizes are not computed and no file handle is kept open.
+* Release the returned object with closePly.
+* @param path Path to file.
+* @return PlyFile object with header information. File information will be empty if probing failed.
+*/
+PlyFile probePly(const char* path);
+/*
+* Get basic information from an in-memory header.
+* The buffer may contain the header only or the header followed by data, which is ignored.
+* Release the returned object with closePly.
+* @param buffer Pointer to header data.
+* @param size Size of buffer in bytes.
+* @return PlyFile object with header information. File information will be empty if parsing failed.
+*/
+PlyFile probePlyBuffer(const void* buffer, const size_t size);
+/*
+* Internally used to read the raw header section of a source, including the end_header line.
+* The source will be positioned at the start of the data section afterwards.
+* @param source Source positioned at the start of the file.
+* @param size Receives the size of the header in bytes.
+* @return Allocated buffer with the header. NULL, if no complete header was found.
+*/
+char* readHeader(PlySource* source, size_t* size);
+/*
+* Internally used to parse a header section and populate elements and properties.
+* Sets encoding, elements and data start of the PlyFile object.
+* @param file PlyFile object to be populated.
+* @param header Pointer to header data.
+* @param size Size of header data in bytes.
+* @return True, if a valid header was found.
+*/
+bool parseHeader(PlyFile* file, const char* header, const size_t size);
+/*
+* Internally used to copy the next line of a header buffer into a null-terminated line buffer.
+* Lines exceeding MUPLY_BUFFER_SIZE are truncated.
+* @param pos Current position in header buffer.
+* @param end End of header buffer.
+* @param line Target buffer with a size of MUPLY_BUFFER_SIZE.
+* @return Position of the next line.
+*/
+const char* nextHeaderLine(const char* pos, const char* end, char* line);
+/*
 * Scan the ply file data and create an index of available properties and data blocks.
 * Forwards to inspectDataAscii or inspectDataBinary.
 * @param file PlyFile for inspection.
@@ -166,6 +445,29 @@ void inspectDataAscii(PlyFile* file);
 */
 void inspectDataBinary(PlyFile* file);
 /*
+* Scan the data block of a single element to get its list sizes and the start of the following element.
+* The start of the element block must be known.
+* Forwards to inspectElementAscii or inspectElementBinary.
+* @param file PlyFile for inspection.
+* @param elemIdx Index of element for inspection.
+* @return True, if the element block could be reached and scanned.
+*/
+bool inspectElement(PlyFile* file, const size_t elemIdx);
+/*
+* Scan the data block of a single element in an ascii-based ply file.
+* @param file PlyFile for inspection.
+* @param elemIdx Index of element for inspection.
+* @return True, if the element block could be reached and scanned.
+*/
+bool inspectElementAscii(PlyFile* file, const size_t elemIdx);
+/*
+* Scan the data block of a single element in a binary-based ply file.
+* @param file PlyFile for inspection.
+* @param elemIdx Index of element for inspection.
+* @return True, if the element block could be reached and scanned.
+*/
+bool inspectElementBinary(PlyFile* file, const size_t elemIdx);
+/*
 * Close file and release all loaded ply data.
 * @param PlyFile object to be closed.
 */
@@ -174,29 +476,604 @@ void closePly(PlyFile* file);
 * Request specific element and properties from file to be read.
 * Define the number of requested properties and their names for loading.
 * The loaded data will be written to the buffers of each PlyProperty object.
-* If the file has not been inspected beforehand, it will be inspectData will be called.
+* On forward-only sources, elements must be requested in file order and preceding elements are skipped.
 * @param file PlyFile object for reading.
 * @param name Name of property to be loaded.
 * @param n Optional parameter with number of requested properties. Omit or set to 0 to load entire vertex data.
 * @param ... C-strings identifying the names of the requested properties.
-* @return True, if target property was found and loaded.
+* @return True, if target element was found and could be reached.
 */
 bool requestElement(PlyFile* file, const char* name, size_t n = 0, ...);
 /*
+* Request several elements with all their properties to be read concurrently.
+* Each element is decoded on its own worker with its own cursor on top of positioned reads,
+* threads of the file are shared by the sizes of the elements estimated from their item and list counts.
+* Forward-only sources and sources without positioned reads load the elements one after another.
+* Elements must not be requested twice in the same call.
+* @param file PlyFile object for reading.
+* @param n Number of requested elements.
+* @param names Names of the requested elements.
+* @return True, if all elements were read.
+*/
+bool requestElements(PlyFile* file, const size_t n, const char* const* names);
+/*
+* Request specific element and properties from file to be read, with property names given as array.
+* @param file PlyFile object for reading.
+* @param name Name of element to be loaded.
+* @param n Number of requested properties, 0 loads all properties.
+* @param names Names of the requested properties.
+* @return True, if target element was found and could be reached.
+*/
+bool requestProperties(PlyFile* file, const char* name, size_t n, const char* const* names);
+/*
+* Internally used to position the source at the start of an element block.
+* Preceding elements of forward-only sources are skipped in file order.
+* @param file PlyFile object.
+* @param elemIdx Index of element.
+* @return True, if the element block could be reached.
+*/
+bool seekElement(PlyFile* file, const int elemIdx);
+/*
+* Stream all items of an element in batches of bounded size without loading the element.
+* Batches are only valid during the callback.
+* @param file PlyFile object for reading.
+* @param name Name of element.
+* @param batchSize Maximum number of items per batch.
+* @param callback Function receiving each batch and the user pointer, return false to stop streaming.
+* @param user User pointer passed to callback.
+* @return True, if all items were streamed.
+*/
+bool streamElement(PlyFile* file, const char* name, const size_t batchSize, bool (*callback)(const PlyBatch* batch, void* user), void* user);
+/*
+* Internally used to stream items of an element, optionally keeping binary records in the byte order of the file.
+* @param file PlyFile object.
+* @param name Name of element.
+* @param batchSize Maximum number of items per batch.
+* @param fileOrder True, if binary records are passed without byteswapping.
+* @param callback Function receiving each batch.
+* @param user User pointer passed to callback.
+* @return True, if all items were streamed.
+*/
+bool streamRecords(PlyFile* file, const char* name, const size_t batchSize, const bool fileOrder, bool (*callback)(const PlyBatch* batch, void* user), void* user);
+/*
+* Internally used to stream items of an element in binary-based ply files.
+* Items are passed without copying unless they need to be byteswapped.
+* @param file PlyFile object positioned at element block.
+* @param elemIdx Index of element.
+* @param batchSize Maximum number of items per batch.
+* @param fileOrder True, if records are passed in the byte order of the file.
+* @param callback Function receiving each batch.
+* @param user User pointer passed to callback.
+* @return True, if all items were streamed.
+*/
+bool streamElementBinary(PlyFile* file, const size_t elemIdx, const size_t batchSize, const bool fileOrder, bool (*callback)(const PlyBatch* batch, void* user), void* user);
+/*
+* Internally used to stream items of an element in ascii-based ply files.
+* @param file PlyFile object positioned at element block.
+* @param elemIdx Index of element.
+* @param batchSize Maximum number of items per batch.
+* @param callback Function receiving each batch.
+* @param user User pointer passed to callback.
+* @return True, if all items were streamed.
+*/
+bool streamElementAscii(PlyFile* file, const size_t elemIdx, const size_t batchSize, bool (*callback)(const PlyBatch* batch, void* user), void* user);
+/*
+* Internally used to convert an ascii token into a binary value.
+* @param token Token for conversion.
+* @param type Type of value.
+* @param dst Target for value.
+* @return Size of value in bytes.
+*/
+size_t parseValue(const char* token, const PlyType type, char* dst);
+/*
+* Internally used to byteswap packed item records in place.
+* @param items Packed item records.
+* @param count Number of items.
+* @param elem Element describing the records.
+* @param nativeLengths True, if list lengths are in native byte order before swapping.
+*/
+void byteSwapItems(char* items, const size_t count, const PlyElement* elem, const bool nativeLengths);
+/*
+* Get a property value from a packed item record.
+* @param item Pointer to item record.
+* @param elem Element describing the record.
+* @param propIdx Index of non-list property.
+* @return Value converted to double.
+*/
+double getItemValue(const char* item, const PlyElement* elem, const size_t propIdx);
+/*
+* Write a header section for a set of elements.
+* Item counts can be padded to be updated in place once all items are written.
+* @param out Target file.
+* @param elements Elements with properties to be written.
+* @param elementCount Number of elements.
+* @param encoding Encoding of data section.
+* @param countOffsets Optional array receiving the file offsets of padded item counts.
+* @return True, if the header was written.
+*/
+bool writeHeader(FILE* out, const PlyElement* elements, const size_t elementCount, const PlyEncoding encoding, long* countOffsets = NULL);
+/*
+* Update a padded item count of a header written by writeHeader.
+* @param out Target file.
+* @param countOffset File offset of item count.
+* @param count New item count.
+* @return True, if the count was written.
+*/
+bool updateItemCount(FILE* out, const long countOffset, const size_t count);
+/*
+* Split an element of a file into spatial grid tiles written as binary ply files.
+* The element is streamed in bounded batches and binned into buffered tile writers,
+* so memory usage is independent of the file size.
+* Bounds are computed in a first pass unless given, items outside are clamped to border tiles.
+* Only the tiled element is written, other elements are dropped.
+* @param path Path of input file.
+* @param tiling Tiling settings.
+* @return True, if all tiles were written.
+*/
+bool tilePly(const char* path, const PlyTiling* tiling);
+/*
+* Stream a ply file into another encoding, optionally keeping only a subset of properties.
+* Elements are converted batch by batch, so memory usage is independent of the file size.
+* Elements without any kept property are dropped.
+* @param file PlyFile object for reading.
+* @param out Target file.
+* @param encoding Encoding of target file.
+* @param n Number of kept property names, 0 keeps all properties.
+* @param properties Names of kept properties.
+* @return True, if all elements were written.
+*/
+bool transcodePly(PlyFile* file, FILE* out, const PlyEncoding encoding, const size_t n = 0, const char* const* properties = NULL);
+/*
+* Check if two files share the same elements and properties.
+* @param file PlyFile object.
+* @param other PlyFile object for comparison.
+* @return True, if element and property names and types match.
+*/
+bool compatiblePly(const PlyFile* file, const PlyFile* other);
+/*
+* Stream a set of ply files with compatible schemas into a single file.
+* Headers are checked first, item counts of the merged file are summed up.
+* Element payloads are streamed file by file in element order, item indices are offset on the fly.
+* @param paths Paths of input files.
+* @param pathCount Number of input files.
+* @param out Target file.
+* @param encoding Encoding of target file.
+* @param indexElement Name of element referenced by item indices.
+* @param indexProperty Name of list property holding item indices.
+* @return True, if all files were merged.
+*/
+bool mergePly(const char* const* paths, const size_t pathCount, FILE* out, const PlyEncoding encoding, const char* indexElement = "vertex", const char* indexProperty = "vertex_indices");
+/*
+* Internally used to add an offset to integer values.
+* @param data Pointer to values, may be unaligned.
+* @param type Type of values.
+* @param count Number of values.
+* @param offset Offset added to each value.
+*/
+void offsetValues(char* data, const PlyType type, const size_t count, const int64_t offset);
+/*
+* Internally used to convert a binary value into an ascii token.
+* @param src Pointer to value, may be unaligned.
+* @param type Type of value.
+* @param dst Target for token, at least 32 characters.
+* @return Length of token.
+*/
+size_t formatValue(const char* src, const PlyType type, char* dst);
+/*
+* Get an element decoded by a process-wide cache shared between threads.
+* Entries are keyed by path, modification time in nanoseconds, file size, element, requested properties and quantization.
+* Concurrent requests of the same entry are coalesced into a single decode.
+* The returned element is read-only and stays valid until it is released.
+* @param path Path of ply file.
+* @param element Name of element.
+* @param n Number of requested properties, 0 loads all properties.
+* @param properties Names of requested properties.
+* @param quantizations Optional quantization modes of the requested properties, QUANT_OCT8 is not supported.
+* @return Shared element, NULL if the element could not be read.
+*/
+const PlyElement* acquireElement(const char* path, const char* element, const size_t n = 0, const char* const* properties = NULL, const PlyQuantization* quantizations = NULL);
+/*
+* Release an element acquired from the cache.
+* Unreferenced entries are evicted in least recently used order while the cache exceeds its budget.
+* @param element Element returned by acquireElement.
+*/
+void releaseElement(const PlyElement* element);
+/*
+* Set the memory budget of the element cache.
+* Unreferenced entries are kept as long as the decoded data fits, the default budget of 0 keeps none.
+* Referenced entries are never evicted, so the budget may be exceeded temporarily.
+* @param bytes Memory budget in bytes.
+*/
+void setCacheBudget(const size_t bytes);
+/*
+* Evict all unreferenced entries of the element cache.
+*/
+void clearCache();
+/*
+* Get index of element by name.
+* @param file PlyFile object for search.
+* @param name Name of element.
+* @return Index of element, -1 if not found.
+*/
+int findElement(const PlyFile* file, const char* name);
+/*
+* Get index of property by name.
+* @param elem Element for search.
+* @param name Name of property.
+* @return Index of property, -1 if not found.
+*/
+int findProperty(const PlyElement* elem, const char* name);
+/*
+* Get a single value of an array of any type.
+* @param data Pointer to values.
+* @param type Type of values.
+* @param idx Index of value.
+* @return Value converted to double.
+*/
+double getValue(const void* data, const PlyType type, const size_t idx);
+/*
+* Select a fixed point quantization of a property to be applied when the element is read.
+* Scale and offset are derived from the value range, which is computed while decoding.
+* Only non-list properties can be quantized. Use QUANT_NONE to read raw values again.
+* Data already loaded keeps its quantization until the element is requested again.
+* @param file PlyFile object.
+* @param element Name of element.
+* @param property Name of property.
+* @param mode QUANT_FIXED16, QUANT_FIXED21 or QUANT_NONE.
+* @return True, if the quantization was set.
+*/
+bool setQuantization(PlyFile* file, const char* element, const char* property, const PlyQuantization mode);
+/*
+* Select octahedral 8bit quantization of normals to be applied when the element is read.
+* The encoded normals are stored with the x component, y and z components release their data.
+* All three components have to be requested for the quantization to take effect.
+* @param file PlyFile object.
+* @param element Name of element.
+* @param nx Name of x component.
+* @param ny Name of y component.
+* @param nz Name of z component.
+* @return True, if the quantization was set.
+*/
+bool setNormalQuantization(PlyFile* file, const char* element, const char* nx, const char* ny, const char* nz);
+/*
+* Internally used to quantize the freshly read properties of an element.
+* @param file PlyFile object.
+* @param elemIdx Index of element.
+*/
+void quantizeProperties(PlyFile* file, const size_t elemIdx);
+/*
+* Get a single value of a quantized or raw non-list property.
+* Octahedral normals yield the x component of the decoded normal.
+* @param prop Property for access.
+* @param idx Index of value.
+* @return Dequantized value.
+*/
+double dequantizeValue(const PlyProperty* prop, const size_t idx);
+/*
+* Dequantize a range of values of a quantized or raw non-list property.
+* Octahedral normals yield the x components of the decoded normals.
+* @param prop Property for access.
+* @param out Target array with space for count values.
+* @param first Index of first value.
+* @param count Number of values.
+*/
+void dequantizeValues(const PlyProperty* prop, float* out, const size_t first, const size_t count);
+/*
+* Get a single normal of octahedral normals.
+* @param prop x component property holding the encoded normals.
+* @param idx Index of normal.
+* @param normal Target for x, y and z component.
+*/
+void dequantizeNormal(const PlyProperty* prop, const size_t idx, float* normal);
+/*
+* Dequantize a range of octahedral normals.
+* @param prop x component property holding the encoded normals.
+* @param out Target array with space for 3 * count interleaved components.
+* @param first Index of first normal.
+* @param count Number of normals.
+*/
+void dequantizeNormals(const PlyProperty* prop, float* out, const size_t first, const size_t count);
+/*
+* Reorder the items of a loaded element along a space-filling curve for better locality.
+* Items are sorted by the curve code of their x, y and z properties using a parallel radix sort.
+* All loaded properties of the element are permuted consistently, including quantized properties.
+* Components of octahedral normals cannot be used as coordinates.
+* If a face element is given, its loaded index lists are remapped to the new item order.
+* Face elements which are loaded afterwards still refer to the original order.
+* @param file PlyFile object with loaded element.
+* @param element Name of element to be reordered.
+* @param x Name of x coordinate property.
+* @param y Name of y coordinate property.
+* @param z Name of z coordinate property.
+* @param curve Space-filling curve for ordering.
+* @param faceElement Optional name of element with index lists to be remapped.
+* @param indexProperty Name of index list property of face element.
+* @return True, if the element was reordered.
+*/
+bool reorderElement(PlyFile* file, const char* element, const char* x, const char* y, const char* z,
+	const PlyCurve curve, const char* faceElement = NULL, const char* indexProperty = "vertex_indices");
+/*
+* Compute the morton code of three 21bit coordinates.
+* @param x First coordinate.
+* @param y Second coordinate.
+* @param z Third coordinate.
+* @return Interleaved 63bit code.
+*/
+uint64_t mortonCode(const uint32_t x, const uint32_t y, const uint32_t z);
+/*
+* Compute the hilbert code of three 21bit coordinates.
+* @param x First coordinate.
+* @param y Second coordinate.
+* @param z Third coordinate.
+* @return 63bit position along the hilbert curve.
+*/
+uint64_t hilbertCode(const uint32_t x, const uint32_t y, const uint32_t z);
+/*
+* Sort keys and attached values with a parallel least significant digit radix sort.
+* The sorted result is returned in keys and values, temporary buffers are used as scratch space.
+* @param keys Keys to be sorted.
+* @param values Values attached to keys.
+* @param tempKeys Scratch space for count keys.
+* @param tempValues Scratch space for count values.
+* @param count Number of keys.
+* @param threads Number of threads.
+*/
+void radixSort(uint64_t* keys, uint32_t* values, uint64_t* tempKeys, uint32_t* tempValues, const size_t count, const size_t threads);
+/*
+* Internally used to permute the loaded property data of an element.
+* Items missing in the new order are dropped, the item count of the element is updated while its file item count is kept.
+* @param file PlyFile object with loaded element.
+* @param elemIdx Index of element.
+* @param order New order of items given by their old indices.
+* @param count Number of items in new order.
+* @param threads Number of threads.
+*/
+void permuteProperties(PlyFile* file, const size_t elemIdx, const uint32_t* order, const size_t count, const size_t threads);
+/*
+* Weld items of a loaded element with equal values of a set of properties into a single item.
+* Items are hashed into a parallel open-addressing table, the first item of each set of equal items is kept.
+* With a positive epsilon values are snapped to a grid of that cell size before comparison.
+* All loaded properties of the element are compacted consistently, including quantized properties.
+* If a face element is given, its loaded index lists are remapped to the welded items.
+* Face elements which are loaded afterwards still refer to the original items.
+* Once items were removed, properties of the welded element cannot be requested again.
+* @param file PlyFile object with loaded element.
+* @param element Name of element to be welded.
+* @param n Number of compared properties, 0 compares all loaded non-list properties which are not quantized.
+* @param properties Names of compared properties, these must not be quantized.
+* @param epsilon Cell size for snapping values, 0 for exact comparison.
+* @param faceElement Optional name of element with index lists to be remapped.
+* @param indexProperty Name of index list property of face element.
+* @param dropUnreferenced True, if items not referenced by the face element should be removed as well.
+* @return True, if the element was welded.
+*/
+bool weldElement(PlyFile* file, const char* element, const size_t n = 0, const char* const* properties = NULL, const double epsilon = 0.0,
+	const char* faceElement = NULL, const char* indexProperty = "vertex_indices", const bool dropUnreferenced = false);
+/*
+* Internally used to hash a 64bit value.
+* @param val Value to be hashed.
+* @return Mixed bits of value.
+*/
+uint64_t hashValue(uint64_t val);
+/*
+* Internally used to replace index values of any integer type through a lookup table.
+* @param data Pointer to index values.
+* @param type Type of index values.
+* @param count Number of index values.
+* @param map Lookup table from old to new indices.
+* @param mapCount Size of lookup table, indices out of range are kept.
+* @param threads Number of threads.
+*/
+void remapIndices(void* data, const PlyType type, const size_t count, const uint32_t* map, const size_t mapCount, const size_t threads);
+/*
 * Internally used to read vertex data from ascii-based ply files.
+* Property buffers are grown if list sizes exceed the allocated property size.
+* Statistics are accumulated per value if requested.
 * @param file PlyFile object prepared for reading.
+* @return True, if the element block could be reached.
 */
-void readPropertiesAscii(PlyFile* file, const size_t elemIdx);
+bool readPropertiesAscii(PlyFile* file, const size_t elemIdx);
+/*
+* Internally used to read fixed-size items from ascii-based ply files.
+* Chunks of complete lines are split at line boundaries and parsed on several threads.
+* @param file PlyFile object prepared for reading.
+* @param elemIdx Index of element positioned at its element block.
+* @return True, if all items were read.
+*/
+bool readFixedPropertiesAscii(PlyFile* file, const size_t elemIdx);
 /*
 * Internally used to read vertex data from binary-based ply files.
-* Performs all necessary byteswaps after reading.
+* Decoding is split across item ranges and threads, byteswaps are performed while decoding.
+* Fixed-size elements of seekable sources are read by each thread with positioned reads,
+* so output pages are first touched by the decoding thread.
+* Other elements are staged in chunks and indexed by blocks of items before decoding.
+* Statistics are accumulated per thread on freshly decoded, cache-resident slices if requested.
+* Property buffers are grown if list sizes exceed the allocated property size.
 * @param file PlyFile object prepared for reading.
+* @return True, if the element block could be read entirely.
+*/
+bool readPropertiesBinary(PlyFile* file, const size_t elemIdx);
+/*
+* Internally used to copy strided values into a dense array with optional byteswapping.
+* @param src Pointer to first value.
+* @param stride Distance between values in bytes.
+* @param count Number of values.
+* @param dst Target array.
+* @param size Size of a single value in bytes.
+* @param swap True, if values need to be byteswapped.
+*/
+void decodeValues(const char* src, const size_t stride, const size_t count, char* dst, const size_t size, const bool swap);
+/*
+* Internally used to check if statistics need to be computed while reading an element.
+* @param file PlyFile object.
+* @param elemIdx Index of element.
+* @return True, if statistics are requested or required for quantization.
+*/
+bool requiresStatistics(const PlyFile* file, const size_t elemIdx);
+/*
+* Accumulate statistics of an array of values.
+* @param data Pointer to values.
+* @param type Type of values.
+* @param count Number of values.
+* @param stats Statistics to be updated.
+*/
+void accumulateStatistics(const void* data, const PlyType type, const size_t count, PlyStatistics* stats);
+/*
+* Merge statistics of two sets of values.
+* @param target Statistics to be updated.
+* @param source Statistics to be merged into target.
+*/
+void mergeStatistics(PlyStatistics* target, const PlyStatistics* source);
+/*
+* Get the mean of property values.
+* @param stats Statistics of values.
+* @return Mean of values, NaN if no values are available.
 */
-void readPropertiesBinary(PlyFile* file, const size_t elemIdx);
+double statisticsMean(const PlyStatistics* stats);
+/*
+* Internally used to read the length of a binary list.
+* @param ptr Pointer to raw list length.
+* @param type Type of list length.
+* @param swap True, if list length needs to be byteswapped.
+* @return Number of list entries.
+*/
+int64_t readListLength(const char* ptr, const PlyType type, const bool swap);
+/*
+* Get the number of threads used for decoding.
+* @param threadCount Requested number of threads, 0 to use all hardware threads.
+* @param itemCount Optional number of items to be processed, limits threads by MUPLY_THREAD_MIN_ITEMS.
+* @return Number of threads.
+*/
+size_t resolveThreadCount(const int threadCount, const size_t itemCount = 0);
+/*
+* Internally used to run a task on several threads.
+* The calling thread executes the first task and waits for all others to finish.
+* @param task Function receiving the arguments, the thread index and the number of threads.
+* @param args Arguments passed to each task.
+* @param threads Number of threads.
+*/
+void runParallel(void (*task)(void* args, size_t thread, size_t threads), void* args, const size_t threads);
 /*
 * Inplace-byteswap properties of element data.
 * @file PlyFile for byteswapping.
 * @elemIdx Index of element for byteswapping.
 */
 void byteSwapProperties(PlyFile* file, const size_t elemIdx);
+/*
+* Internally used to allocate the read buffer of a source if necessary.
+* @param source Source for initialization.
+*/
+void initSource(PlySource* source);
+/*
+* Internally used to close a source and release its buffer.
+* @param source Source to be closed.
+*/
+void closeSource(PlySource* source);
+/*
+* Check if a source supports random access.
+* @param source Source for checking.
+* @return True, if source is seekable or held in memory.
+*/
+bool sourceSeekable(const PlySource* source);
+/*
+* Get the current absolute read position of a source.
+* @param source Source for query.
+* @return Absolute read position.
+*/
+long sourceTell(const PlySource* source);
+/*
+* Internally used to refill the read buffer of a source.
+* @param source Source for reading.
+* @return True, if new data is available.
+*/
+bool sourceFill(PlySource* source);
+/*
+* Read data from a source, similar to fread.
+* @param source Source for reading.
+* @param buffer Target buffer.
+* @param size Number of bytes to read.
+* @return Number of bytes read.
+*/
+size_t sourceRead(PlySource* source, void* buffer, const size_t size);
+/*
+* Read a line from a source, similar to fgets.
+* @param source Source for reading.
+* @param line Target buffer.
+* @param size Size of target buffer.
+* @return Pointer to line or NULL, if no data is left.
+*/
+char* sourceGets(PlySource* source, char* line, const size_t size);
+/*
+* Internally used to make a number of bytes directly accessible in the read buffer of a source.
+* The buffer is grown if necessary, the read position is not changed.
+* @param source Source for reading.
+* @param size Number of requested bytes.
+* @return Number of bytes accessible from source->buffer + source->bufferPos, less than size at the end of data.
+*/
+size_t sourceEnsure(PlySource* source, const size_t size);
+/*
+* Jump to absolute position of a source.
+* Forward-only sources can only skip ahead.
+* @param source Source for seeking.
+* @param offset Absolute target position.
+* @return True, if the target position was reached.
+*/
+bool sourceSeek(PlySource* source, const long offset);
+/*
+* Skip bytes of a source.
+* @param source Source for skipping.
+* @param count Number of bytes to skip.
+* @return True, if the target position was reached.
+*/
+bool sourceSkip(PlySource* source, const long count);
+/*
+* Internally used to stage complete lines in the source buffer.
+* The chunk size is doubled if a single line does not fit.
+* @param source Source for reading.
+* @param maxLines Maximum number of staged lines.
+* @param chunkSize Number of bytes to stage, may be grown.
+* @param used Receives the number of bytes of the staged lines.
+* @return Number of staged lines starting at source->buffer + source->bufferPos, 0 at the end of data.
+*/
+size_t stageLines(PlySource* source, const size_t maxLines, size_t* chunkSize, size_t* used);
+/*
+* Internally used to count line breaks in a block of text.
+* Uses 16-byte SSE2 comparisons where available.
+* @param data Block of text.
+* @param size Size of block.
+* @return Number of line breaks.
+*/
+size_t countLines(const char* data, const size_t size);
+/*
+* Internally used to skip a number of lines in a block of text.
+* Uses 16-byte SSE2 comparisons where available.
+* @param data Block of text.
+* @param size Size of block.
+* @param lines Number of lines to skip, receives the number of skipped lines.
+* @return Position after the last skipped line break.
+*/
+const char* findLines(const char* data, const size_t size, size_t* lines);
+/*
+* Internally used to skip separators within a line.
+* @param pos Current position.
+* @param end End of text.
+* @return Position of next token or line break.
+*/
+const char* skipSpaces(const char* pos, const char* end);
+/*
+* Internally used to skip a token.
+* Uses 16-byte SSE2 whitespace classification where available.
+* @param pos Start of token.
+* @param end End of text.
+* @return Position after token.
+*/
+const char* skipToken(const char* pos, const char* end);
+/*
+* Internally used to copy a token into a zero-terminated buffer.
+* @param pos Start of token.
+* @param tokenEnd End of token.
+* @param token Target buffer of MUPLY_TOKEN_SIZE characters, long tokens are truncated.
+* @return Pointer to token.
+*/
+const char* copyToken(const char* pos, const char* tokenEnd, char* token);
 #endif
\ No newline at end of file
@@ -0,0 +1,47 @@
+#include "muply.h"
+
+void printUsage() {
+	printf("usage: plyconvert <input> <output> <encoding> [property ...]\n");
+	printf("encoding: ascii, binary_little_endian or binary_big_endian\n");
+	printf("use - as input or output for stdin or stdout\n");
+	printf("properties: names of kept properties, all properties are kept if omitted\n");
+}
+
+int main(int argc, char** argv) {
+	if (argc < 4) {
+		printUsage();
+		return 1;
+	}
+	const PlyEncoding encoding = str2PlyEncoding(argv[3]);
+	if (encoding == PlyEncoding::UNKNOWN) {
+		printUsage();
+		return 1;
+	}
+	// open input and output
+	const bool useStdin = !strcmp(argv[1], "-");
+	const bool useStdout = !strcmp(argv[2], "-");
+	PlyFile pfile = useStdin ? openPlyStream(stdin) : openPly(argv[1]);
+	if (!pfile.elementCount) {
+		fprintf(stderr, "could not read file: %s\n", argv[1]);
+		return 1;
+	}
+	FILE* out = useStdout ? stdout : fopen(argv[2], "wb");
+	if (!out) {
+		fprintf(stderr, "could not write file: %s\n", argv[2]);
+		closePly(&pfile);
+		return 1;
+	}
+
+	// stream input into output
+	const bool success = transcodePly(&pfile, out, encoding, argc - 4, argv + 4);
+	if (!success) {
+		fprintf(stderr, "conversion failed\n");
+	}
+
+	// cleanup
+	if (!useStdout) {
+		fclose(out);
+	}
+	closePly(&pfile);
+	return success ? 0 : 1;
+}